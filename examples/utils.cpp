@@ -13,6 +13,14 @@
 #include <stdexcept>
 #include <string>
 
+#if defined(__unix__) || defined(__APPLE__)
+# define VTZERO_EXAMPLES_HAVE_MMAP
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
 /**
  * Read complete contents of a file into a string.
  *
@@ -42,6 +50,60 @@ std::string read_file(const std::string& filename) {
     return buffer;
 }
 
+mapped_file::mapped_file(const std::string& filename, bool sequential) {
+#ifdef VTZERO_EXAMPLES_HAVE_MMAP
+    if (!filename.empty() && filename != "-") {
+        const int fd = ::open(filename.c_str(), O_RDONLY); // NOLINT(cppcoreguidelines-pro-type-vararg,hicpp-vararg)
+        if (fd == -1) {
+            throw std::runtime_error{std::string{"Can not open file '"} + filename + "'"};
+        }
+
+        struct stat file_stat{};
+        if (::fstat(fd, &file_stat) != 0) {
+            ::close(fd);
+            throw std::runtime_error{std::string{"Can not stat file '"} + filename + "'"};
+        }
+
+        const auto size = static_cast<std::size_t>(file_stat.st_size);
+        if (size > 0) {
+            void* addr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            ::close(fd);
+            if (addr == MAP_FAILED) { // NOLINT(cppcoreguidelines-pro-type-cstyle-cast,performance-no-int-to-ptr)
+                throw std::runtime_error{std::string{"Can not mmap file '"} + filename + "'"};
+            }
+
+            if (sequential) {
+                // prefetch hint for front-to-back scan jobs, failure is
+                // not a problem
+                ::madvise(addr, size, MADV_SEQUENTIAL);
+                ::madvise(addr, size, MADV_WILLNEED);
+            }
+
+            m_data = static_cast<const char*>(addr);
+            m_size = size;
+            m_mapped = true;
+        } else {
+            ::close(fd);
+        }
+        return;
+    }
+#else
+    static_cast<void>(sequential);
+#endif
+
+    m_buffer = read_file(filename);
+    m_data = m_buffer.data();
+    m_size = m_buffer.size();
+}
+
+mapped_file::~mapped_file() {
+#ifdef VTZERO_EXAMPLES_HAVE_MMAP
+    if (m_mapped) {
+        ::munmap(const_cast<char*>(m_data), m_size); // NOLINT(cppcoreguidelines-pro-type-const-cast)
+    }
+#endif
+}
+
 /**
  * Write contents of a buffer into a file.
  *
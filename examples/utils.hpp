@@ -1,10 +1,57 @@
 
 #include <vtzero/vector_tile.hpp>
 
+#include <cstddef>
 #include <string>
 
 std::string read_file(const std::string& filename);
 
+/**
+ * A read-only memory-mapped file handing out a data_view into the mapping.
+ *
+ * Because vector_tile, layer, and feature are all data_view-based, tiles
+ * from the mapping are decoded in place, no file contents are ever copied
+ * into heap buffers. On platforms without mmap() the file is read into an
+ * internal buffer instead, so code using this class works everywhere.
+ *
+ * The data_view stays valid as long as the mapped_file is alive.
+ */
+class mapped_file {
+
+    std::string m_buffer{};
+    const char* m_data = nullptr;
+    std::size_t m_size = 0;
+    bool m_mapped = false;
+
+public:
+
+    /**
+     * Map the specified file into memory.
+     *
+     * @param filename The file name. Can be empty or "-" to read from
+     *        STDIN (which always uses the buffer fallback).
+     * @param sequential Set this if you are going to scan the file
+     *        front-to-back; it is turned into a prefetch hint
+     *        (madvise(MADV_SEQUENTIAL)) to the OS where supported.
+     * @throws various exceptions if there is an error
+     */
+    explicit mapped_file(const std::string& filename, bool sequential = false);
+
+    ~mapped_file();
+
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    mapped_file(mapped_file&&) = delete;
+    mapped_file& operator=(mapped_file&&) = delete;
+
+    /// The contents of the file.
+    vtzero::data_view data() const noexcept {
+        return {m_data, m_size};
+    }
+
+}; // class mapped_file
+
 void write_data_to_file(const std::string& buffer, const std::string& filename);
 
 vtzero::layer get_layer(const vtzero::vector_tile& tile, const std::string& layer_name_or_num);
@@ -0,0 +1,268 @@
+/*****************************************************************************
+
+  Example program for vtzero library.
+
+  vtzero-bench - Run microbenchmarks for the decode/encode hot paths
+
+  The results are written to stdout as JSON, one object per benchmark,
+  so they can be collected and compared between releases.
+
+*****************************************************************************/
+
+#include "utils.hpp"
+
+#include <vtzero/builder.hpp>
+#include <vtzero/geometry.hpp>
+#include <vtzero/index.hpp>
+#include <vtzero/property_mapper.hpp>
+#include <vtzero/vector_tile.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// A benchmark is run this many times, the minimum and mean run time are
+// reported. Can be changed with the -r option.
+static int repeats = 5;
+
+static bool first_result = true;
+
+template <typename TFunc>
+static void run_benchmark(const char* name, TFunc&& func) {
+    using clock = std::chrono::steady_clock;
+
+    func(); // warm up
+
+    int64_t min_ns = 0;
+    int64_t sum_ns = 0;
+    for (int n = 0; n < repeats; ++n) {
+        const auto start = clock::now();
+        func();
+        const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count();
+        sum_ns += ns;
+        if (min_ns == 0 || ns < min_ns) {
+            min_ns = ns;
+        }
+    }
+
+    if (!first_result) {
+        std::cout << ",\n";
+    }
+    first_result = false;
+    std::cout << "  {\"name\": \"" << name
+              << "\", \"repeats\": " << repeats
+              << ", \"min_ns\": " << min_ns
+              << ", \"mean_ns\": " << (sum_ns / repeats) << '}';
+}
+
+namespace {
+
+    struct counting_geom_handler {
+
+        std::size_t count = 0;
+
+        void points_begin(uint32_t /*count*/) const noexcept {
+        }
+
+        void points_point(const vtzero::point /*point*/) noexcept {
+            ++count;
+        }
+
+        void points_end() const noexcept {
+        }
+
+        void linestring_begin(uint32_t /*count*/) const noexcept {
+        }
+
+        void linestring_point(const vtzero::point /*point*/) noexcept {
+            ++count;
+        }
+
+        void linestring_end() const noexcept {
+        }
+
+        void ring_begin(uint32_t /*count*/) const noexcept {
+        }
+
+        void ring_point(const vtzero::point /*point*/) noexcept {
+            ++count;
+        }
+
+        void ring_end(vtzero::ring_type /*rt*/) const noexcept {
+        }
+
+    }; // struct counting_geom_handler
+
+} // anonymous namespace
+
+static void bench_decode_geometries(const std::string& data) {
+    run_benchmark("decode_geometries", [&data]() {
+        counting_geom_handler handler;
+        vtzero::vector_tile tile{data};
+        while (auto layer = tile.next_layer()) {
+            while (auto feature = layer.next_feature()) {
+                switch (feature.geometry_type()) {
+                    case vtzero::GeomType::POINT:
+                        vtzero::decode_point_geometry(feature.geometry(), handler);
+                        break;
+                    case vtzero::GeomType::LINESTRING:
+                        vtzero::decode_linestring_geometry(feature.geometry(), handler);
+                        break;
+                    case vtzero::GeomType::POLYGON:
+                        vtzero::decode_polygon_geometry(feature.geometry(), handler);
+                        break;
+                    default:
+                        break;
+                }
+            }
+        }
+        if (handler.count == 0) {
+            throw std::runtime_error{"no points decoded"};
+        }
+    });
+}
+
+static void bench_layer_table_init(const std::string& data) {
+    run_benchmark("layer_table_init", [&data]() {
+        vtzero::vector_tile tile{data};
+        std::size_t sum = 0;
+        while (auto layer = tile.next_layer()) {
+            sum += layer.key_table().size();
+            sum += layer.value_table().size();
+        }
+        (void)sum;
+    });
+}
+
+static void bench_tile_builder_serialize(const std::string& data) {
+    run_benchmark("tile_builder_serialize", [&data]() {
+        vtzero::vector_tile tile{data};
+        vtzero::tile_builder tbuilder;
+        while (auto layer = tile.next_layer()) {
+            tbuilder.add_existing_layer(layer);
+        }
+        const std::string out = tbuilder.serialize();
+        if (out.empty()) {
+            throw std::runtime_error{"empty tile"};
+        }
+    });
+}
+
+static void bench_index_insert() {
+    // Synthetic keys/values: many lookups, few distinct entries, like the
+    // property tables of a typical tile.
+    std::vector<std::string> keys;
+    keys.reserve(10000);
+    for (int n = 0; n < 10000; ++n) {
+        keys.push_back("key_" + std::to_string(n % 500));
+    }
+
+    run_benchmark("key_index_insert", [&keys]() {
+        vtzero::tile_builder tbuilder;
+        vtzero::layer_builder lbuilder{tbuilder, "test"};
+        vtzero::key_index<> index{lbuilder};
+        uint64_t sum = 0;
+        for (const auto& key : keys) {
+            sum += index(key).value();
+        }
+        (void)sum;
+    });
+
+    run_benchmark("value_index_insert", [&keys]() {
+        vtzero::tile_builder tbuilder;
+        vtzero::layer_builder lbuilder{tbuilder, "test"};
+        vtzero::value_index_internal<> index{lbuilder};
+        uint64_t sum = 0;
+        for (const auto& key : keys) {
+            sum += index(vtzero::encoded_property_value{key}).value();
+        }
+        (void)sum;
+    });
+}
+
+static void bench_property_mapper(const std::string& data) {
+    run_benchmark("property_mapper_remap", [&data]() {
+        vtzero::vector_tile tile{data};
+        vtzero::tile_builder tbuilder;
+        while (auto layer = tile.next_layer()) {
+            vtzero::layer_builder lbuilder{tbuilder, layer};
+            vtzero::property_mapper mapper{layer, lbuilder};
+            while (auto feature = layer.next_feature()) {
+                vtzero::geometry_feature_builder fbuilder{lbuilder};
+                fbuilder.copy_id(feature);
+                fbuilder.set_geometry(feature.geometry());
+                fbuilder.copy_properties(feature, mapper);
+                fbuilder.commit();
+            }
+        }
+        const std::string out = tbuilder.serialize();
+        if (out.empty()) {
+            throw std::runtime_error{"empty tile"};
+        }
+    });
+}
+
+static void bench_encode_linestring() {
+    // Synthetic GPS-trace-like linestring with 100k points.
+    std::vector<vtzero::point> points;
+    points.reserve(100000);
+    int32_t x = 0;
+    int32_t y = 0;
+    for (int n = 0; n < 100000; ++n) {
+        x += 1 + (n % 7);
+        y += 1 + (n % 5);
+        points.push_back({x, y});
+    }
+
+    run_benchmark("encode_linestring_100k", [&points]() {
+        vtzero::tile_builder tbuilder;
+        vtzero::layer_builder lbuilder{tbuilder, "test"};
+        vtzero::linestring_feature_builder fbuilder{lbuilder};
+        fbuilder.add_linestring(points.data(), points.data() + points.size());
+        fbuilder.commit();
+        const std::string out = tbuilder.serialize();
+        if (out.empty()) {
+            throw std::runtime_error{"empty tile"};
+        }
+    });
+}
+
+int main(int argc, char* argv[]) {
+    std::string input_file;
+
+    for (int n = 1; n < argc; ++n) {
+        const std::string arg{argv[n]};
+        if (arg == "-r" && n + 1 < argc) {
+            repeats = std::atoi(argv[++n]); // NOLINT(cert-err34-c)
+        } else {
+            input_file = arg;
+        }
+    }
+
+    if (input_file.empty() || repeats < 1) {
+        std::cerr << "Usage: " << argv[0] << " [-r REPEATS] TILE\n";
+        return 1;
+    }
+
+    try {
+        const auto data = read_file(input_file);
+
+        std::cout << "{\"tile\": \"" << input_file << "\", \"benchmarks\": [\n";
+        bench_decode_geometries(data);
+        bench_layer_table_init(data);
+        bench_tile_builder_serialize(data);
+        bench_index_insert();
+        bench_property_mapper(data);
+        bench_encode_linestring();
+        std::cout << "\n]}\n";
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << '\n';
+        return 1;
+    }
+
+    return 0;
+}
@@ -4,222 +4,133 @@
 
   vtzero-check - Check vector tiles for validity
 
+  With a single tile the messages are written to stderr and the return
+  code tells you the worst problem found (0 - okay, 1 - warning,
+  2 - error, 3 - fatal error).
+
+  With several tiles they are checked concurrently by a worker pool and
+  aggregate throughput is reported.
+
 *****************************************************************************/
 
 #include "utils.hpp"
 
-#include <vtzero/vector_tile.hpp>
+#include <vtzero/validate.hpp>
 
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
 #include <iostream>
-#include <set>
+#include <mutex>
 #include <stdexcept>
 #include <string>
+#include <thread>
+#include <vector>
 
-class result {
-
-    int m_return_code = 0;
-
-public:
-
-    void has_warning() noexcept {
-        if (m_return_code < 1) {
-            m_return_code = 1;
-        }
-    }
-
-    void has_error() noexcept {
-        if (m_return_code < 2) {
-            m_return_code = 2;
-        }
-    }
-
-    void has_fatal_error() noexcept {
-        if (m_return_code < 3) {
-            m_return_code = 3;
-        }
-    }
-
-    int return_code() const noexcept {
-        return m_return_code;
-    }
-
-} result;
+static int check_one_tile(const std::string& filename) {
+    const auto data = read_file(filename);
 
-class CheckGeomHandler {
+    vtzero::validation_result result;
+    vtzero::validate(vtzero::data_view{data}, result);
 
-    vtzero::point m_prev_point{};
-    int m_layer_num;
-    int m_feature_num;
-    int64_t m_extent;
-    bool m_is_first_point = false;
-    int m_count = 0;
-
-    void print_context() const {
-        std::cerr << " in layer " << m_layer_num
-                  << " in feature " << m_feature_num
-                  << " in geometry " << m_count
-                  << ": ";
-    }
-
-    void print_error(const char* message) const {
-        result.has_error();
-        std::cerr << "Error";
-        print_context();
+    for (const auto& message : result.messages()) {
         std::cerr << message << '\n';
     }
 
-    void print_warning(const char* message) const {
-        result.has_warning();
-        std::cerr << "Warning";
-        print_context();
-        std::cerr << message << '\n';
-    }
+    return result.return_code();
+}
 
-    void check_point_location(const vtzero::point point) const {
-        if (point.x < -m_extent ||
-            point.y < -m_extent ||
-            point.x > 2 * m_extent ||
-            point.y > 2 * m_extent) {
-            print_warning("point waaaay beyond the extent");
-        }
+static int check_many_tiles(const std::vector<std::string>& filenames, std::size_t num_threads) {
+    if (num_threads < 1) {
+        num_threads = 1;
     }
-
-public:
-
-    CheckGeomHandler(uint32_t extent, int layer_num, int feature_num) :
-        m_layer_num(layer_num),
-        m_feature_num(feature_num),
-        m_extent(static_cast<int64_t>(extent)) {
+    if (num_threads > filenames.size()) {
+        num_threads = filenames.size();
     }
 
-    // ----------------------------------------------------------------------
+    std::atomic<std::size_t> next_file{0};
+    std::atomic<int> worst{0};
+    std::atomic<std::size_t> num_not_ok{0};
+    std::mutex output_mutex;
 
-    void points_begin(const uint32_t /*count*/) const {
-    }
+    const auto start = std::chrono::steady_clock::now();
 
-    void points_point(const vtzero::point point) const {
-        check_point_location(point);
-    }
+    const auto worker = [&]() {
+        // per-thread result, reused from tile to tile
+        vtzero::validation_result result;
 
-    void points_end() const {
-    }
+        while (true) {
+            const auto n = next_file.fetch_add(1);
+            if (n >= filenames.size()) {
+                return;
+            }
 
-    // ----------------------------------------------------------------------
+            result.clear();
+            try {
+                const auto data = read_file(filenames[n]);
+                vtzero::validate(vtzero::data_view{data}, result);
+            } catch (const std::exception& e) {
+                result.add_fatal_error(std::string{"Fatal error: "} + e.what());
+            }
 
-    void linestring_begin(const uint32_t count) {
-        if (count < 2) {
-            print_error("Not enough points in linestring");
-        }
-        m_is_first_point = true;
-    }
+            if (!result.ok()) {
+                ++num_not_ok;
+                int w = worst.load();
+                while (w < result.return_code() && !worst.compare_exchange_weak(w, result.return_code())) {
+                }
 
-    void linestring_point(const vtzero::point point) {
-        if (m_is_first_point) {
-            m_is_first_point = false;
-        } else {
-            if (point == m_prev_point) {
-                print_error("Duplicate point in linestring");
+                const std::lock_guard<std::mutex> lock{output_mutex};
+                for (const auto& message : result.messages()) {
+                    std::cerr << filenames[n] << ": " << message << '\n';
+                }
             }
         }
-        m_prev_point = point;
+    };
 
-        check_point_location(point);
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads);
+    for (std::size_t n = 0; n < num_threads; ++n) {
+        threads.emplace_back(worker);
     }
-
-    void linestring_end() {
-        ++m_count;
+    for (auto& thread : threads) {
+        thread.join();
     }
 
-    // ----------------------------------------------------------------------
+    const auto duration = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
 
-    void ring_begin(const uint32_t count) {
-        if (count < 4) {
-            print_error("Not enough points in ring");
-        }
-        m_is_first_point = true;
-    }
+    std::cerr << "Checked " << filenames.size() << " tiles in " << duration << "s ("
+              << (duration > 0.0 ? static_cast<double>(filenames.size()) / duration : 0.0)
+              << " tiles/s) using " << num_threads << " threads, "
+              << num_not_ok << " tiles with problems\n";
 
-    void ring_point(const vtzero::point point) {
-        if (m_is_first_point) {
-            m_is_first_point = false;
-        } else {
-            if (point == m_prev_point) {
-                print_error("Duplicate point in ring");
-            }
-        }
-        m_prev_point = point;
+    return worst.load();
+}
 
-        check_point_location(point);
-    }
+int main(int argc, char* argv[]) {
+    std::size_t num_threads = std::thread::hardware_concurrency();
+    std::vector<std::string> filenames;
 
-    void ring_end(const vtzero::ring_type rt) {
-        if (rt == vtzero::ring_type::invalid) {
-            print_error("Invalid ring with area 0");
-        }
-        if (m_count == 0 && rt != vtzero::ring_type::outer) {
-            print_error("First ring isn't an outer ring");
+    for (int n = 1; n < argc; ++n) {
+        const std::string arg{argv[n]};
+        if (arg == "-j" && n + 1 < argc) {
+            num_threads = static_cast<std::size_t>(std::atoi(argv[++n])); // NOLINT(cert-err34-c)
+        } else {
+            filenames.push_back(arg);
         }
-        ++m_count;
     }
 
-}; // class CheckGeomHandler
-
-int main(int argc, char* argv[]) {
-    if (argc != 2) {
-        std::cerr << "Usage: " << argv[0] << " TILE\n";
+    if (filenames.empty()) {
+        std::cerr << "Usage: " << argv[0] << " [-j THREADS] TILE [TILE...]\n";
         return 1;
     }
 
-    std::string input_file{argv[1]};
-    const auto data = read_file(input_file);
-
-    std::set<std::string> layer_names;
-
-    vtzero::vector_tile tile{data};
-
-    int layer_num = 0;
-    int feature_num = -1;
     try {
-        while (auto layer = tile.next_layer()) {
-            if (layer.name().empty()) {
-                std::cerr << "Error in layer " << layer_num << ": name is empty (spec 4.1)\n";
-                result.has_error();
-            }
-
-            std::string name(layer.name());
-            if (layer_names.count(name) > 0) {
-                std::cerr << "Error in layer " << layer_num << ": name is duplicate of previous layer ('" << name << "') (spec 4.1)\n";
-                result.has_error();
-            }
-
-            layer_names.insert(name);
-
-            feature_num = 0;
-            while (auto feature = layer.next_feature()) {
-                CheckGeomHandler handler{layer.extent(), layer_num, feature_num};
-                vtzero::decode_geometry(feature.geometry(), handler);
-                ++feature_num;
-            }
-            if (feature_num == 0) {
-                std::cerr << "Warning: No features in layer " << layer_num << " (spec 4.1)\n";
-                result.has_warning();
-            }
-            feature_num = -1;
-            ++layer_num;
-        }
-        if (layer_num == 0) {
-            std::cerr << "Warning: No layers in vector tile (spec 4.1)\n";
-            result.has_warning();
+        if (filenames.size() == 1) {
+            return check_one_tile(filenames.front());
         }
+        return check_many_tiles(filenames, num_threads);
     } catch (const std::exception& e) {
-        std::cerr << "Fatal error in layer " << layer_num;
-        if (feature_num >= 0) {
-            std::cerr << " in feature " << feature_num;
-        }
-        std::cerr << ": " << e.what() << '\n';
-        result.has_fatal_error();
+        std::cerr << "Error: " << e.what() << '\n';
+        return 3;
     }
-
-    return result.return_code();
 }
-
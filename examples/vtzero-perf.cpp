@@ -0,0 +1,361 @@
+/*****************************************************************************
+
+  Example program for vtzero library.
+
+  vtzero-perf - Performance regression harness on a synthetic tile corpus
+
+  Unlike vtzero-bench, which runs microbenchmarks on one real tile, this
+  harness generates a corpus of synthetic tiles with controlled shape
+  (feature counts, points per geometry, key/value table sizes, layer
+  counts) and runs complete decode/encode/copy pipelines over it. The
+  measured times can be written to a baseline file and later runs can be
+  checked against that baseline:
+
+    vtzero-perf --write-baseline perf-baseline.txt
+    ... change the code ...
+    vtzero-perf --baseline perf-baseline.txt --threshold 15
+
+  The check fails (exit code 1) if any pipeline got slower than the
+  baseline by more than the threshold (in percent).
+
+*****************************************************************************/
+
+#include <vtzero/builder.hpp>
+#include <vtzero/geometry.hpp>
+#include <vtzero/property_mapper.hpp>
+#include <vtzero/vector_tile.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+// A pipeline is run this many times, the minimum run time is used. Can be
+// changed with the -r option.
+static int repeats = 3;
+
+/**
+ * The shape of one synthetic tile in the corpus. All tiles are generated
+ * deterministically from their spec, so runs are comparable.
+ */
+struct corpus_spec {
+    const char* name;
+    vtzero::GeomType geom_type;
+    int num_layers;
+    int num_features;    // per layer
+    int num_points;      // per geometry (per ring for polygons)
+    int num_keys;        // distinct keys per layer
+    int num_values;      // distinct values per layer
+};
+
+static const corpus_spec corpus[] = {
+    {"points-small-tables", vtzero::GeomType::POINT,      1, 10000,  1,  10,   20},
+    {"points-large-tables", vtzero::GeomType::POINT,      1, 10000,  1, 400,  800},
+    {"linestrings",         vtzero::GeomType::LINESTRING, 1,  1000, 100,  20,   50},
+    {"polygons",            vtzero::GeomType::POLYGON,    1,   500,  64,  20,   50},
+    {"many-layers",         vtzero::GeomType::POINT,     16,   500,  1,  10,   20},
+};
+
+// Simple deterministic generator for the coordinate jitter.
+static uint32_t lcg(uint32_t& state) noexcept {
+    state = state * 1664525U + 1013904223U;
+    return state >> 16U;
+}
+
+static std::string generate_tile(const corpus_spec& spec) {
+    vtzero::tile_builder tbuilder;
+    uint32_t state = 42;
+
+    for (int l = 0; l < spec.num_layers; ++l) {
+        vtzero::layer_builder lbuilder{tbuilder, "layer_" + std::to_string(l)};
+
+        for (int f = 0; f < spec.num_features; ++f) {
+            const auto base_x = static_cast<int32_t>(lcg(state) % 4096U);
+            const auto base_y = static_cast<int32_t>(lcg(state) % 4096U);
+
+            const std::string key = "key_" + std::to_string(f % spec.num_keys);
+            const std::string value = "value_" + std::to_string(f % spec.num_values);
+            const auto id = static_cast<uint64_t>(f) + 1;
+
+            switch (spec.geom_type) {
+                case vtzero::GeomType::POINT: {
+                    vtzero::point_feature_builder fbuilder{lbuilder};
+                    fbuilder.set_id(id);
+                    fbuilder.add_point(base_x, base_y);
+                    fbuilder.add_property(key, value);
+                    fbuilder.commit();
+                    break;
+                }
+                case vtzero::GeomType::LINESTRING: {
+                    vtzero::linestring_feature_builder fbuilder{lbuilder};
+                    fbuilder.set_id(id);
+                    fbuilder.add_linestring(static_cast<uint32_t>(spec.num_points));
+                    int32_t x = base_x;
+                    int32_t y = base_y;
+                    for (int p = 0; p < spec.num_points; ++p) {
+                        fbuilder.set_point(x, y);
+                        x += 1 + static_cast<int32_t>(lcg(state) % 7U);
+                        y += 1 + static_cast<int32_t>(lcg(state) % 5U);
+                    }
+                    fbuilder.add_property(key, value);
+                    fbuilder.commit();
+                    break;
+                }
+                default: { // vtzero::GeomType::POLYGON
+                    // a regular polygon, large enough that all integer
+                    // vertices are distinct
+                    vtzero::polygon_feature_builder fbuilder{lbuilder};
+                    fbuilder.set_id(id);
+                    fbuilder.add_ring(static_cast<uint32_t>(spec.num_points) + 1);
+                    const double radius = 500.0;
+                    for (int p = 0; p < spec.num_points; ++p) {
+                        const double angle = 2.0 * 3.141592653589793 * p / spec.num_points;
+                        fbuilder.set_point(static_cast<int32_t>(std::round(radius * std::cos(angle))) + base_x,
+                                           static_cast<int32_t>(std::round(radius * std::sin(angle))) + base_y);
+                    }
+                    fbuilder.close_ring();
+                    fbuilder.add_property(key, value);
+                    fbuilder.commit();
+                    break;
+                }
+            }
+        }
+    }
+
+    return tbuilder.serialize();
+}
+
+namespace {
+
+    struct counting_geom_handler {
+
+        std::size_t count = 0;
+
+        void points_begin(uint32_t /*count*/) const noexcept {
+        }
+
+        void points_point(const vtzero::point /*point*/) noexcept {
+            ++count;
+        }
+
+        void points_end() const noexcept {
+        }
+
+        void linestring_begin(uint32_t /*count*/) const noexcept {
+        }
+
+        void linestring_point(const vtzero::point /*point*/) noexcept {
+            ++count;
+        }
+
+        void linestring_end() const noexcept {
+        }
+
+        void ring_begin(uint32_t /*count*/) const noexcept {
+        }
+
+        void ring_point(const vtzero::point /*point*/) noexcept {
+            ++count;
+        }
+
+        void ring_end(vtzero::ring_type /*rt*/) const noexcept {
+        }
+
+    }; // struct counting_geom_handler
+
+} // anonymous namespace
+
+// The decode pipeline: iterate everything, decode all geometries, and
+// touch all properties.
+static void pipeline_decode(const std::string& data) {
+    counting_geom_handler handler;
+    std::size_t num_properties = 0;
+    vtzero::vector_tile tile{data};
+    while (auto layer = tile.next_layer()) {
+        while (auto feature = layer.next_feature()) {
+            vtzero::decode_geometry(feature.geometry(), handler);
+            feature.for_each_property([&](const vtzero::property& p) noexcept {
+                num_properties += p.key().size();
+                return true;
+            });
+        }
+    }
+    if (handler.count == 0 || num_properties == 0) {
+        throw std::runtime_error{"decode pipeline came up empty"};
+    }
+}
+
+// The encode pipeline: generate the tile from its spec.
+static void pipeline_encode(const corpus_spec& spec) {
+    const std::string out = generate_tile(spec);
+    if (out.empty()) {
+        throw std::runtime_error{"encode pipeline came up empty"};
+    }
+}
+
+// The copy pipeline: re-encode the tile feature by feature with remapped
+// property tables.
+static void pipeline_copy(const std::string& data) {
+    vtzero::vector_tile tile{data};
+    vtzero::tile_builder tbuilder;
+    while (auto layer = tile.next_layer()) {
+        vtzero::layer_builder lbuilder{tbuilder, layer};
+        vtzero::property_mapper mapper{layer, lbuilder};
+        while (auto feature = layer.next_feature()) {
+            vtzero::geometry_feature_builder fbuilder{lbuilder};
+            fbuilder.copy_id(feature);
+            fbuilder.set_geometry(feature.geometry());
+            fbuilder.copy_properties(feature, mapper);
+            fbuilder.commit();
+        }
+    }
+    const std::string out = tbuilder.serialize();
+    if (out.empty()) {
+        throw std::runtime_error{"copy pipeline came up empty"};
+    }
+}
+
+template <typename TFunc>
+static int64_t measure(TFunc&& func) {
+    using clock = std::chrono::steady_clock;
+
+    func(); // warm up
+
+    int64_t min_ns = 0;
+    for (int n = 0; n < repeats; ++n) {
+        const auto start = clock::now();
+        func();
+        const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count();
+        if (min_ns == 0 || ns < min_ns) {
+            min_ns = ns;
+        }
+    }
+
+    return min_ns;
+}
+
+static std::map<std::string, int64_t> run_pipelines() {
+    std::map<std::string, int64_t> results;
+
+    for (const auto& spec : corpus) {
+        const std::string data = generate_tile(spec);
+        const std::string name{spec.name};
+
+        results[name + "/decode"] = measure([&data]() {
+            pipeline_decode(data);
+        });
+        results[name + "/encode"] = measure([&spec]() {
+            pipeline_encode(spec);
+        });
+        results[name + "/copy"] = measure([&data]() {
+            pipeline_copy(data);
+        });
+    }
+
+    return results;
+}
+
+static void write_baseline(const std::string& filename, const std::map<std::string, int64_t>& results) {
+    std::ofstream file{filename};
+    if (!file) {
+        throw std::runtime_error{"can not open baseline file: " + filename};
+    }
+    for (const auto& result : results) {
+        file << result.first << ' ' << result.second << '\n';
+    }
+}
+
+static std::map<std::string, int64_t> read_baseline(const std::string& filename) {
+    std::ifstream file{filename};
+    if (!file) {
+        throw std::runtime_error{"can not open baseline file: " + filename};
+    }
+    std::map<std::string, int64_t> baseline;
+    std::string name;
+    int64_t ns = 0;
+    while (file >> name >> ns) {
+        baseline[name] = ns;
+    }
+    return baseline;
+}
+
+static bool check_against_baseline(const std::map<std::string, int64_t>& results,
+                                   const std::map<std::string, int64_t>& baseline,
+                                   const double threshold_percent) {
+    bool okay = true;
+    for (const auto& result : results) {
+        const auto it = baseline.find(result.first);
+        if (it == baseline.end()) {
+            std::cout << result.first << ": " << result.second << " ns (not in baseline)\n";
+            continue;
+        }
+        const double limit = static_cast<double>(it->second) * (1.0 + threshold_percent / 100.0);
+        const bool failed = static_cast<double>(result.second) > limit;
+        std::cout << result.first << ": " << result.second
+                  << " ns (baseline " << it->second << " ns)"
+                  << (failed ? " REGRESSION\n" : "\n");
+        if (failed) {
+            okay = false;
+        }
+    }
+    return okay;
+}
+
+int main(int argc, char* argv[]) {
+    std::string baseline_file;
+    bool write = false;
+    double threshold_percent = 10.0;
+
+    for (int n = 1; n < argc; ++n) {
+        const std::string arg{argv[n]};
+        if (arg == "-r" && n + 1 < argc) {
+            repeats = std::atoi(argv[++n]); // NOLINT(cert-err34-c)
+        } else if (arg == "--write-baseline" && n + 1 < argc) {
+            baseline_file = argv[++n];
+            write = true;
+        } else if (arg == "--baseline" && n + 1 < argc) {
+            baseline_file = argv[++n];
+        } else if (arg == "--threshold" && n + 1 < argc) {
+            threshold_percent = std::atof(argv[++n]); // NOLINT(cert-err34-c)
+        } else {
+            baseline_file.clear();
+            break;
+        }
+    }
+
+    if (baseline_file.empty() || repeats < 1) {
+        std::cerr << "Usage: " << argv[0] << " [-r REPEATS] [--threshold PERCENT] --write-baseline FILE\n"
+                  << "       " << argv[0] << " [-r REPEATS] [--threshold PERCENT] --baseline FILE\n";
+        return 1;
+    }
+
+    try {
+        const auto results = run_pipelines();
+
+        if (write) {
+            write_baseline(baseline_file, results);
+            for (const auto& result : results) {
+                std::cout << result.first << ": " << result.second << " ns\n";
+            }
+            return 0;
+        }
+
+        const auto baseline = read_baseline(baseline_file);
+        if (!check_against_baseline(results, baseline, threshold_percent)) {
+            std::cerr << "Performance regression detected (threshold " << threshold_percent << "%)\n";
+            return 1;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << '\n';
+        return 1;
+    }
+
+    return 0;
+}
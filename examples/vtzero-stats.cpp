@@ -8,23 +8,12 @@
 
 #include "utils.hpp"
 
-#include <vtzero/vector_tile.hpp>
+#include <vtzero/stats.hpp>
 
 #include <iostream>
 #include <stdexcept>
 #include <string>
 
-static std::size_t geometries_size(const vtzero::layer& layer) {
-    std::size_t sum = 0;
-
-    layer.for_each_feature([&sum](vtzero::feature&& feature) {
-        sum += feature.geometry().data().size();
-        return true;
-    });
-
-    return sum;
-}
-
 int main(int argc, char* argv[]) {
     if (argc != 2) {
         std::cerr << "Usage: " << argv[0] << " TILE\n";
@@ -34,18 +23,18 @@ int main(int argc, char* argv[]) {
     std::cout << "layer,num_features,raw_size,raw_geometries_size,key_table_size,value_table_size\n";
     try {
         std::string input_file{argv[1]};
-        const auto data = read_file(input_file);
+        const mapped_file input{input_file, true};
 
-        vtzero::vector_tile tile{data};
+        const auto stats = vtzero::scan_stats(input.data());
 
-        while (const auto layer = tile.next_layer()) {
-            std::cout.write(layer.name().data(), static_cast<std::streamsize>(layer.name().size()));
+        for (const auto& layer : stats.layers) {
+            std::cout.write(layer.name.data(), static_cast<std::streamsize>(layer.name.size()));
             std::cout << ','
-                      << layer.num_features() << ','
-                      << layer.data().size() << ','
-                      << geometries_size(layer) << ','
-                      << layer.key_table().size() << ','
-                      << layer.value_table().size() << '\n';
+                      << layer.num_features << ','
+                      << layer.raw_size << ','
+                      << layer.geometries_size << ','
+                      << layer.key_table_size << ','
+                      << layer.value_table_size << '\n';
         }
     } catch (const std::exception& e) {
         std::cerr << "Error: " << e.what() << '\n';
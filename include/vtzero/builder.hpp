@@ -19,6 +19,7 @@ documentation.
 #include "builder_impl.hpp"
 #include "feature_builder_impl.hpp"
 #include "geometry.hpp"
+#include "runtime_stats.hpp"
 #include "types.hpp"
 #include "vector_tile.hpp"
 
@@ -35,6 +36,59 @@ documentation.
 
 namespace vtzero {
 
+    /**
+     * The result of tile_builder::serialize_segments(): a sequence of
+     * (pointer, length) segments which, concatenated, are the encoded
+     * vector tile. The pbf field headers are owned by this object, the
+     * layer bodies are views into the buffers of the tile_builder and
+     * into the data of layers added with add_existing_layer(). Use this
+     * to hand an encoded tile to a scatter-gather output function such
+     * as writev() without copying the layer bodies:
+     *
+     * @code
+     * const auto segments = builder.serialize_segments();
+     * std::vector<iovec> iov;
+     * for (const auto segment : segments.segments()) {
+     *   iov.push_back({const_cast<char*>(segment.data()), segment.size()});
+     * }
+     * writev(fd, iov.data(), iov.size());
+     * @endcode
+     *
+     * The segments are only valid as long as this object, the
+     * tile_builder, and the data of all existing layers added to it are
+     * alive and unchanged.
+     */
+    class tile_segments {
+
+        friend class tile_builder;
+
+        // This is a vector (and not a std::string) on purpose: the
+        // segments point into this buffer and unlike a string with its
+        // small string optimization, a vector can be moved around without
+        // invalidating them.
+        std::vector<char> m_headers;
+        std::vector<data_view> m_segments;
+
+    public:
+
+        /// The segments making up the encoded vector tile, in order.
+        const std::vector<data_view>& segments() const noexcept {
+            return m_segments;
+        }
+
+        /// The sum of the sizes of all segments in bytes.
+        std::size_t size() const noexcept {
+            std::size_t sum = 0;
+            for (const auto segment : m_segments) {
+                sum += segment.size();
+            }
+            return sum;
+        }
+
+    }; // class tile_segments
+
+    class standalone_layer_builder;
+
     /**
      * Used to build vector tiles. Whenever you are building a new vector
      * tile, start with an object of this class and add layers. After all
@@ -56,6 +110,10 @@ namespace vtzero {
 
         std::vector<std::unique_ptr<detail::layer_builder_impl>> m_layers;
 
+        // Layers retired by clear(). They are reused by add_layer(), so
+        // their buffer capacities survive from one tile to the next.
+        std::vector<std::unique_ptr<detail::layer_builder_impl>> m_reusable_layers;
+
         /**
          * Add a new layer to the vector tile based on an existing layer. The
          * new layer will have the same name, version, and extent as the
@@ -64,9 +122,7 @@ namespace vtzero {
          * existing layer.
          */
         detail::layer_builder_impl* add_layer(const layer& layer) {
-            auto* ptr = new detail::layer_builder_impl{layer.name(), layer.version(), layer.extent()};
-            m_layers.emplace_back(ptr);
-            return ptr;
+            return add_layer(layer.name(), layer.version(), layer.extent());
         }
 
         /**
@@ -83,9 +139,14 @@ namespace vtzero {
          */
         template <typename TString>
         detail::layer_builder_impl* add_layer(TString&& name, uint32_t version, uint32_t extent) {
-            auto* ptr = new detail::layer_builder_impl{std::forward<TString>(name), version, extent};
-            m_layers.emplace_back(ptr);
-            return ptr;
+            if (!m_reusable_layers.empty()) {
+                m_layers.push_back(std::move(m_reusable_layers.back()));
+                m_reusable_layers.pop_back();
+                m_layers.back()->reset(std::forward<TString>(name), version, extent);
+            } else {
+                m_layers.emplace_back(new detail::layer_builder_impl{std::forward<TString>(name), version, extent});
+            }
+            return m_layers.back().get();
         }
 
     public:
@@ -131,10 +192,47 @@ namespace vtzero {
             add_existing_layer(layer.data());
         }
 
+        /**
+         * Remove all layers from this builder, so it can be used to build
+         * the next vector tile. The layers built from scratch are kept
+         * around internally and reused (including the capacity of their
+         * buffers) by later layer_builders, so encoding many tiles with a
+         * similar layer structure doesn't have to allocate the buffers
+         * again for every tile.
+         *
+         * All layer_builders and feature builders pointing into this
+         * tile_builder are invalidated by this call.
+         */
+        void clear() {
+            for (auto& layer : m_layers) {
+                if (!layer->is_copy()) {
+                    m_reusable_layers.push_back(std::move(layer));
+                }
+            }
+            m_layers.clear();
+        }
+
+        /**
+         * The exact number of bytes serialize() will append to its buffer.
+         * Use this if you want to allocate the output buffer yourself
+         * before calling serialize().
+         *
+         * Complexity: Linear in the number of layers.
+         *
+         * @returns Size of the encoded vector tile in bytes.
+         */
+        std::size_t serialized_size() const noexcept {
+            return std::accumulate(m_layers.cbegin(), m_layers.cend(), 0ULL, [](std::size_t sum, const std::unique_ptr<detail::layer_builder_impl>& layer) {
+                return sum + layer->serialized_size();
+            });
+        }
+
         /**
          * Serialize the data accumulated in this builder into a vector tile.
          * The data will be appended to the specified buffer. The buffer
-         * doesn't have to be empty.
+         * doesn't have to be empty. The buffer is resized exactly once,
+         * because the exact size of the encoded vector tile is known
+         * beforehand.
          *
          * @tparam TBuffer Type of buffer. Must be std:string or other buffer
          *         type supported by protozero.
@@ -142,17 +240,40 @@ namespace vtzero {
          */
         template <typename TBuffer>
         void serialize(TBuffer& buffer) const {
-            const std::size_t estimated_size = std::accumulate(m_layers.cbegin(), m_layers.cend(), 0ULL, [](std::size_t sum, const std::unique_ptr<detail::layer_builder_impl>& layer) {
-                return sum + layer->estimated_size();
-            });
-
+            VTZERO_STATS_COUNT(tiles_serialized);
             protozero::basic_pbf_builder<TBuffer, detail::pbf_tile> pbf_tile_builder{buffer};
-            pbf_tile_builder.reserve(estimated_size);
+            pbf_tile_builder.reserve(serialized_size());
             for (const auto& layer : m_layers) {
                 layer->build(pbf_tile_builder);
             }
         }
 
+        /**
+         * Serialize the data accumulated in this builder into a sequence
+         * of (pointer, length) segments instead of one contiguous buffer.
+         * The layer bodies are not copied, the segments reference the
+         * internal buffers of this builder and the data of the layers
+         * added with add_existing_layer(). See the tile_segments class
+         * for the lifetime rules.
+         *
+         * @returns The segments making up the encoded vector tile.
+         */
+        tile_segments serialize_segments() const {
+            tile_segments result;
+
+            // Make sure the headers buffer never reallocates, the segments
+            // point into it. Per layer the header is one byte for the field
+            // key plus at most five bytes for the length varint.
+            result.m_headers.reserve(m_layers.size() * 6);
+            result.m_segments.reserve(m_layers.size() * 4);
+
+            for (const auto& layer : m_layers) {
+                layer->build_segments(result.m_headers, result.m_segments);
+            }
+
+            return result;
+        }
+
         /**
          * Serialize the data accumulated in this builder into a vector_tile
          * and return it.
@@ -168,6 +289,60 @@ namespace vtzero {
             return data;
         }
 
+        /**
+         * Serialize all layers added to this builder so far, hand the
+         * encoded data to the sink, and then remove the layers from the
+         * builder (see clear()).
+         *
+         * Because every layer is a self-contained field of the tile
+         * message, a tile can be written out incrementally, layer by
+         * layer. Calling this function whenever a layer is finished bounds
+         * the peak memory of the encoder by the size of the largest layer
+         * instead of the whole tile:
+         *
+         * @code
+         * tile_builder builder;
+         * for (...) {
+         *   layer_builder layer{builder, "example"};
+         *   ... // add features
+         *   builder.flush_layers([&](const data_view data) {
+         *     write(fd, data.data(), data.size());
+         *   });
+         * }
+         * @endcode
+         *
+         * The concatenation of all the data handed to the sink is the same
+         * encoded vector tile that a single serialize() call would have
+         * created.
+         *
+         * All layer_builders and feature builders pointing into this
+         * tile_builder are invalidated by this call.
+         *
+         * @tparam TFunc The type of the sink. It must be callable with a
+         *         single argument of type data_view. The data the view
+         *         points to is only valid for the duration of the call.
+         * @param sink The sink to hand the encoded data to.
+         */
+        template <typename TFunc>
+        void flush_layers(TFunc&& sink) {
+            const auto segments = serialize_segments();
+            for (const auto segment : segments.segments()) {
+                sink(segment);
+            }
+            clear();
+        }
+
+        /**
+         * Attach a layer that was built with a standalone_layer_builder to
+         * this tile. The layer buffers are handed over by move, no data is
+         * copied. The layer is added after all layers already in this
+         * builder.
+         *
+         * @param layer The standalone_layer_builder with the finished
+         *        layer. It must not be used any more after this call.
+         */
+        void attach_layer(standalone_layer_builder&& layer);
+
     }; // class tile_builder
 
     /**
@@ -179,6 +354,12 @@ namespace vtzero {
         vtzero::detail::layer_builder_impl* m_layer;
 
         friend class geometry_feature_builder;
+        friend class layer_remapper;
+        friend class property_mapper;
+        friend class standalone_layer_builder;
+        friend class tile_merger;
+        template <typename TSchema>
+        friend class static_layer_builder;
         friend class point_feature_builder;
         friend class linestring_feature_builder;
         friend class polygon_feature_builder;
@@ -190,6 +371,13 @@ namespace vtzero {
         template <typename T>
         using is_layer = std::is_same<typename std::remove_cv<typename std::remove_reference<T>::type>::type, layer>;
 
+    protected:
+
+        /// Construct a layer_builder manipulating the specified layer.
+        explicit layer_builder(vtzero::detail::layer_builder_impl* layer) noexcept :
+            m_layer(layer) {
+        }
+
     public:
 
         /**
@@ -218,6 +406,20 @@ namespace vtzero {
             m_layer(tile.add_layer(std::forward<TString>(name), version, extent)) {
         }
 
+        /**
+         * Reserve capacity in the internal buffers of this layer. If you
+         * know approximately how large the encoded layer will get, this
+         * avoids the repeated buffer growth (and the malloc traffic that
+         * comes with it) while the features, keys, and values are added.
+         *
+         * @param data_size Capacity for the buffer with the features.
+         * @param keys_size Capacity for the buffer with the keys table.
+         * @param values_size Capacity for the buffer with the values table.
+         */
+        void reserve(std::size_t data_size, std::size_t keys_size = 0, std::size_t values_size = 0) {
+            m_layer->reserve(data_size, keys_size, values_size);
+        }
+
         /**
          * Add key to the keys table without checking for duplicates. This
          * function is usually used when an external index is used which takes
@@ -300,8 +502,131 @@ namespace vtzero {
          */
         void add_feature(const feature& feature);
 
+        /**
+         * Copy a feature from an existing layer to the new layer without
+         * decoding it. The raw feature data is spliced into the output
+         * as-is.
+         *
+         * This is only correct if the key and value tables of the existing
+         * layer were copied to the new layer verbatim (for instance with
+         * tile_builder::add_existing_layer() or a layer_remapper on a
+         * freshly created layer), because the property indexes in the
+         * copied feature are not rewritten.
+         *
+         * @param feature The feature to copy.
+         * @pre @code feature.valid() @endcode
+         */
+        void copy_feature(const feature& feature) {
+            vtzero_assert(feature.valid());
+            m_layer->message().add_bytes(detail::pbf_layer::features, feature.data());
+            m_layer->increment_feature_count();
+        }
+
+        /**
+         * Copy a feature from an existing layer to the new layer without
+         * decoding its geometry or properties, but give it a new ID. Only
+         * the ID field is rewritten, the geometry and the packed property
+         * indexes are copied as raw data.
+         *
+         * The same precondition as for copy_feature(const feature&)
+         * applies: the key and value tables of the existing layer must have
+         * been copied to the new layer verbatim.
+         *
+         * @param feature The feature to copy.
+         * @param id The ID the copied feature should get.
+         * @pre @code feature.valid() @endcode
+         */
+        void copy_feature(const feature& feature, uint64_t id) {
+            vtzero_assert(feature.valid());
+            protozero::pbf_builder<detail::pbf_feature> feature_writer{m_layer->message(), detail::pbf_layer::features};
+            feature_writer.add_uint64(detail::pbf_feature::id, id);
+
+            protozero::pbf_message<detail::pbf_feature> reader{feature.data()};
+            while (reader.next()) {
+                switch (reader.tag_and_type()) {
+                    case protozero::tag_and_type(detail::pbf_feature::id, protozero::pbf_wire_type::varint):
+                        reader.skip(); // replaced by the new ID
+                        break;
+                    case protozero::tag_and_type(detail::pbf_feature::tags, protozero::pbf_wire_type::length_delimited):
+                        feature_writer.add_bytes(detail::pbf_feature::tags, reader.get_view());
+                        break;
+                    case protozero::tag_and_type(detail::pbf_feature::type, protozero::pbf_wire_type::varint):
+                        feature_writer.add_enum(detail::pbf_feature::type, reader.get_enum());
+                        break;
+                    case protozero::tag_and_type(detail::pbf_feature::geometry, protozero::pbf_wire_type::length_delimited):
+                        feature_writer.add_bytes(detail::pbf_feature::geometry, reader.get_view());
+                        break;
+                    default:
+                        reader.skip(); // ignore unknown fields
+                }
+            }
+            m_layer->increment_feature_count();
+        }
+
     }; // class layer_builder
 
+    /**
+     * A layer_builder that is not tied to a tile_builder. It owns its own
+     * buffers, so independent layers of a tile can be built concurrently
+     * on different threads without any locking and then be attached to a
+     * tile_builder with tile_builder::attach_layer() for the final
+     * serialization. The attach is a cheap hand-off of the buffers, no
+     * data is copied.
+     *
+     * @code
+     * vtzero::standalone_layer_builder roads{"roads"};
+     * ... // add features (possibly on a worker thread)
+     *
+     * vtzero::tile_builder builder;
+     * builder.attach_layer(std::move(roads));
+     * std::string data = builder.serialize();
+     * @endcode
+     *
+     * After a standalone_layer_builder has been attached to a tile, it
+     * (and all feature builders created from it) must not be used any
+     * more.
+     */
+    class standalone_layer_builder : public layer_builder {
+
+        friend class tile_builder;
+
+        std::unique_ptr<detail::layer_builder_impl> m_impl;
+
+    public:
+
+        /**
+         * Construct a standalone_layer_builder for a completely new layer.
+         *
+         * @tparam TString Some string type (such as std::string or const char*)
+         * @param name The name of the new layer.
+         * @param version The vector tile spec version of the new layer.
+         * @param extent The extent of the new layer.
+         */
+        template <typename TString>
+        explicit standalone_layer_builder(TString&& name, uint32_t version = 2, uint32_t extent = 4096) :
+            layer_builder(new detail::layer_builder_impl{std::forward<TString>(name), version, extent}),
+            m_impl(&get_layer_impl()) {
+        }
+
+        /**
+         * Construct a standalone_layer_builder for a new layer with the
+         * same name, version, and extent as an existing layer.
+         *
+         * @param layer Existing layer we want to use the name, version, and
+         *        extent from
+         */
+        explicit standalone_layer_builder(const layer& layer) :
+            standalone_layer_builder(layer.name(), layer.version(), layer.extent()) {
+        }
+
+    }; // class standalone_layer_builder
+
+    inline void tile_builder::attach_layer(standalone_layer_builder&& layer) {
+        vtzero_assert(layer.m_impl &&
+                      "The standalone_layer_builder was already attached to a tile");
+        m_layers.push_back(std::move(layer.m_impl));
+    }
+
     /**
      * Parent class for the point_feature_builder, linestring_feature_builder
      * and polygon_feature_builder classes. You can not instantiate this class
@@ -381,6 +706,19 @@ namespace vtzero {
             return static_cast<uint32_t>(size);
         }
 
+        /// Delta- and zigzag-encode all points in the range [begin, end)
+        /// in one tight batch loop without the per-point bookkeeping of
+        /// set_point().
+        void encode_points(const point* begin, const point* end) {
+            point cursor = m_cursor;
+            for (const point* it = begin; it != end; ++it) {
+                m_pbf_geometry.add_element(protozero::encode_zigzag32(it->x - cursor.x));
+                m_pbf_geometry.add_element(protozero::encode_zigzag32(it->y - cursor.y));
+                cursor = *it;
+            }
+            m_cursor = cursor;
+        }
+
         /// Helper function to make sure we have everything before adding a property
         void prepare_to_add_property() {
             if (m_pbf_geometry.valid()) {
@@ -418,6 +756,22 @@ namespace vtzero {
         /// Builder classes can be moved
         feature_builder& operator=(feature_builder&& other) noexcept = default;
 
+        /**
+         * Make sure the internal buffer has room for a geometry with the
+         * specified number of points, so it doesn't have to grow while
+         * the points are set. The reservation assumes the worst-case
+         * varint encoding of the coordinates, so it never reserves too
+         * little. Useful before adding large geometries whose size is
+         * known beforehand.
+         *
+         * @param num_points The number of points the geometry will have.
+         */
+        void reserve_geometry(const uint32_t num_points) {
+            // Worst case per point: two 5-byte varints. Plus the command
+            // integers and the field header of the geometry.
+            reserve_additional_impl(static_cast<std::size_t>(num_points) * 10 + 16);
+        }
+
         /**
          * Set the ID of this feature.
          *
@@ -524,6 +878,52 @@ namespace vtzero {
             add_property_impl(std::forward<TKey>(key), std::forward<TValue>(value));
         }
 
+        /**
+         * Add all properties in the range [begin, end) to this feature in
+         * one batch. Use this instead of calling add_property() in a loop
+         * when you already have the resolved index values, for instance
+         * when re-encoding features whose properties are stored in arrays.
+         * Can only be called after all the methods manipulating the
+         * geometry.
+         *
+         * @param begin Pointer to the first index value pair.
+         * @param end Pointer one past the last index value pair.
+         * @pre All index value pairs in the range must be valid.
+         */
+        void add_properties(const index_value_pair* begin, const index_value_pair* end) {
+            vtzero_assert(m_feature_writer.valid() &&
+                          "Can not call add_properties() after commit() or rollback()");
+            prepare_to_add_property();
+            for (const index_value_pair* it = begin; it != end; ++it) {
+                vtzero_assert(it->valid());
+                m_pbf_tags.add_element(it->key().value());
+                m_pbf_tags.add_element(it->value().value());
+            }
+        }
+
+        /**
+         * Add all properties in the range [begin, end) to this feature in
+         * one batch. The range contains raw key/value indexes into the
+         * layer tables in the interleaved order they appear in the encoded
+         * tags field, ie. key index, value index, key index, value index,
+         * and so on. Can only be called after all the methods manipulating
+         * the geometry.
+         *
+         * @param begin Pointer to the first index.
+         * @param end Pointer one past the last index.
+         * @pre The number of indexes in the range must be even.
+         */
+        void add_properties(const uint32_t* begin, const uint32_t* end) {
+            vtzero_assert(m_feature_writer.valid() &&
+                          "Can not call add_properties() after commit() or rollback()");
+            vtzero_assert((end - begin) % 2 == 0 &&
+                          "add_properties() needs an even number of indexes");
+            prepare_to_add_property();
+            for (const uint32_t* it = begin; it != end; ++it) {
+                m_pbf_tags.add_element(*it);
+            }
+        }
+
         /**
          * Commit this feature. Call this after all the details of this
          * feature have been added. If this is not called, the feature
@@ -752,6 +1152,30 @@ namespace vtzero {
             }
         }
 
+        /**
+         * Add all points in the range [begin, end) as multipoint geometry
+         * to this feature. This is equivalent to calling add_points() with
+         * the number of points followed by one set_point() call per point,
+         * but encodes the whole span in one batch loop which is faster for
+         * large geometries.
+         *
+         * @param begin Pointer to the first point.
+         * @param end Pointer one past the last point.
+         *
+         * @throws geometry_exception If there are more than 2^29-1 points
+         *         in the range.
+         *
+         * @pre @code begin != end @endcode
+         *
+         * @pre You must not have any calls to add_property() before calling
+         *      this method.
+         */
+        void add_points(const point* begin, const point* end) {
+            add_points(check_num_points(static_cast<std::size_t>(end - begin)));
+            encode_points(begin, end);
+            m_num_points.set(0);
+        }
+
     }; // class point_feature_builder
 
     /**
@@ -816,6 +1240,27 @@ namespace vtzero {
             m_start_line = true;
         }
 
+        /**
+         * Same as add_linestring(count), but when reserve is true the
+         * internal buffer is pre-sized for the worst-case encoding of
+         * this linestring first, so it doesn't have to grow while the
+         * points are set. See reserve_geometry().
+         *
+         * @param count The number of points in the linestring.
+         * @param reserve Pre-size the internal buffer?
+         *
+         * @pre @code count > 1 && count < 2^29 @endcode
+         *
+         * @pre You must not have any calls to add_property() before calling
+         *      this method.
+         */
+        void add_linestring(const uint32_t count, const bool reserve) {
+            if (reserve) {
+                reserve_geometry(count);
+            }
+            add_linestring(count);
+        }
+
         /**
          * Set a point in the multilinestring geometry opened with
          * add_linestring().
@@ -925,6 +1370,40 @@ namespace vtzero {
             }
         }
 
+        /**
+         * Add all points in the range [begin, end) as a linestring geometry
+         * to this feature. This is equivalent to calling add_linestring()
+         * with the number of points followed by one set_point() call per
+         * point, but encodes the whole span in one batch loop which is
+         * faster for large geometries.
+         *
+         * @param begin Pointer to the first point.
+         * @param end Pointer one past the last point.
+         *
+         * @throws geometry_exception If there are more than 2^29-1 points
+         *         in the range or if two consecutive points are identical.
+         *
+         * @pre @code end - begin > 1 @endcode
+         *
+         * @pre You must not have any calls to add_property() before calling
+         *      this method.
+         */
+        void add_linestring(const point* begin, const point* end) {
+            add_linestring(check_num_points(static_cast<std::size_t>(end - begin)));
+            set_point(*begin); // writes the MoveTo and LineTo commands
+            point cursor = m_cursor;
+            for (const point* it = begin + 1; it != end; ++it) {
+                if (*it == cursor) {
+                    throw geometry_exception{"Zero-length segments in linestrings are not allowed."};
+                }
+                m_pbf_geometry.add_element(protozero::encode_zigzag32(it->x - cursor.x));
+                m_pbf_geometry.add_element(protozero::encode_zigzag32(it->y - cursor.y));
+                cursor = *it;
+            }
+            m_cursor = cursor;
+            m_num_points.set(0);
+        }
+
     }; // class linestring_feature_builder
 
     /**
@@ -990,6 +1469,27 @@ namespace vtzero {
             m_start_ring = true;
         }
 
+        /**
+         * Same as add_ring(count), but when reserve is true the internal
+         * buffer is pre-sized for the worst-case encoding of this ring
+         * first, so it doesn't have to grow while the points are set.
+         * See reserve_geometry().
+         *
+         * @param count The number of points in the ring.
+         * @param reserve Pre-size the internal buffer?
+         *
+         * @pre @code count > 3 && count < 2^29 @endcode
+         *
+         * @pre You must not have any calls to add_property() before calling
+         *      this method.
+         */
+        void add_ring(const uint32_t count, const bool reserve) {
+            if (reserve) {
+                reserve_geometry(count);
+            }
+            add_ring(count);
+        }
+
         /**
          * Set a point in the ring opened with add_ring().
          *
@@ -1138,6 +1638,44 @@ namespace vtzero {
             }
         }
 
+        /**
+         * Add all points in the range [begin, end) as a ring to this
+         * feature. This is equivalent to calling add_ring() with the number
+         * of points followed by one set_point() call per point, but encodes
+         * the whole span in one batch loop which is faster for large
+         * geometries.
+         *
+         * @param begin Pointer to the first point.
+         * @param end Pointer one past the last point. The last point must
+         *        be the same as the first point to close the ring.
+         *
+         * @throws geometry_exception If there are more than 2^29-1 points
+         *         in the range or if two consecutive points are identical
+         *         or if the last point is not the same as the first point.
+         *
+         * @pre @code end - begin > 3 @endcode
+         *
+         * @pre You must not have any calls to add_property() before calling
+         *      this method.
+         */
+        void add_ring(const point* begin, const point* end) {
+            add_ring(check_num_points(static_cast<std::size_t>(end - begin)));
+            set_point(*begin); // writes the MoveTo and LineTo commands
+            const point* last = end - 1;
+            point cursor = m_cursor;
+            for (const point* it = begin + 1; it != last; ++it) {
+                if (*it == cursor) {
+                    throw geometry_exception{"Zero-length segments in rings are not allowed."};
+                }
+                m_pbf_geometry.add_element(protozero::encode_zigzag32(it->x - cursor.x));
+                m_pbf_geometry.add_element(protozero::encode_zigzag32(it->y - cursor.y));
+                cursor = *it;
+            }
+            m_cursor = cursor;
+            m_num_points.set(1);
+            set_point(*last); // writes the ClosePath command
+        }
+
     }; // class polygon_feature_builder
 
     /**
@@ -18,15 +18,21 @@ documentation.
 
 #include "encoded_property_value.hpp"
 #include "property_value.hpp"
+#include "runtime_stats.hpp"
 #include "types.hpp"
 
 #include <protozero/basic_pbf_builder.hpp>
+#include <protozero/pbf_builder.hpp>
 #include <protozero/pbf_message.hpp>
+#include <protozero/varint.hpp>
 
 #include <cstdlib>
+#include <initializer_list>
+#include <iterator>
 #include <string>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 namespace vtzero {
 
@@ -102,6 +108,7 @@ namespace vtzero {
             }
 
             index_value add_value_without_dup_check(const data_view text) {
+                VTZERO_STATS_GROWTH_GUARD(m_values_data);
                 m_pbf_message_values.add_string(detail::pbf_layer::values, text);
                 return m_num_values++;
             }
@@ -177,11 +184,74 @@ namespace vtzero {
                 return m_version;
             }
 
+            // Is this layer a copy of an existing layer (added with
+            // add_existing_layer())?
+            bool is_copy() const noexcept {
+                return m_data_view.data() != nullptr;
+            }
+
+            // Remove everything from this layer and initialize it again
+            // with new metadata. The capacity of the internal buffers is
+            // retained, so a reused layer doesn't have to allocate its
+            // buffers again.
+            template <typename TString>
+            void reset(TString&& name, uint32_t version, uint32_t extent) {
+                m_data_view = data_view{};
+                m_data.clear();
+                m_keys_data.clear();
+                m_values_data.clear();
+                m_pbf_message_layer = protozero::pbf_builder<detail::pbf_layer>{m_data};
+                m_pbf_message_keys = protozero::pbf_builder<detail::pbf_layer>{m_keys_data};
+                m_pbf_message_values = protozero::pbf_builder<detail::pbf_layer>{m_values_data};
+                m_num_features = 0;
+                m_version = version;
+                m_num_keys = 0;
+                m_num_values = 0;
+                m_keys_index.clear();
+                m_values_index.clear();
+                m_pbf_message_layer.add_uint32(detail::pbf_layer::version, version);
+                m_pbf_message_layer.add_string(detail::pbf_layer::name, std::forward<TString>(name));
+                m_pbf_message_layer.add_uint32(detail::pbf_layer::extent, extent);
+            }
+
+            // Reserve capacity in the internal buffers. Avoids repeated
+            // reallocation while the buffers grow if the approximate size
+            // of the layer is known beforehand.
+            void reserve(std::size_t data_size, std::size_t keys_size, std::size_t values_size) {
+                m_data.reserve(data_size);
+                m_keys_data.reserve(keys_size);
+                m_values_data.reserve(values_size);
+            }
+
+            // Make sure there is room for at least size more bytes in the
+            // buffer with the encoded layer metadata and features without
+            // it having to grow.
+            void reserve_additional(const std::size_t size) {
+                m_data.reserve(m_data.size() + size);
+            }
+
             index_value add_key_without_dup_check(const data_view text) {
+                VTZERO_STATS_GROWTH_GUARD(m_keys_data);
                 m_pbf_message_keys.add_string(detail::pbf_layer::keys, text);
                 return m_num_keys++;
             }
 
+            // Append pre-encoded key table entries (a sequence of encoded
+            // "keys" fields) in one go. Used by the static_layer_builder
+            // which prepares this blob once per schema. Must only be
+            // called before the lazily built index is populated, ie.
+            // right after construction.
+            void append_keys_data(const std::string& data, const uint32_t num_entries) {
+                m_keys_data.append(data);
+                m_num_keys += num_entries;
+            }
+
+            // Same as append_keys_data() but for the value table.
+            void append_values_data(const std::string& data, const uint32_t num_entries) {
+                m_values_data.append(data);
+                m_num_values += num_entries;
+            }
+
             index_value add_key(const data_view text) {
                 const auto index = find_in_keys_table(text);
                 if (index.valid()) {
@@ -226,19 +296,62 @@ namespace vtzero {
                 ++m_num_features;
             }
 
-            std::size_t estimated_size() const {
+            // The exact number of bytes build() will append to the tile.
+            // This is the size of the layer content plus the exact overhead
+            // for the pbf encoding of the layers field.
+            std::size_t serialized_size() const noexcept {
+                std::size_t content_size = 0;
                 if (m_data_view.data()) {
                     // This is a layer created as copy from an existing layer
-                    constexpr const std::size_t estimated_overhead_for_pbf_encoding = 8;
-                    return m_data_view.size() + estimated_overhead_for_pbf_encoding;
+                    content_size = m_data_view.size();
+                } else {
+                    // This is a layer created from scratch
+                    if (m_num_features == 0) {
+                        return 0; // build() will not add empty layers
+                    }
+                    content_size = data().size() +
+                                   keys_data().size() +
+                                   values_data().size();
                 }
 
-                // This is a layer created from scratch
-                constexpr const std::size_t estimated_overhead_for_pbf_encoding = 8;
-                return data().size() +
-                       keys_data().size() +
-                       values_data().size() +
-                       estimated_overhead_for_pbf_encoding;
+                constexpr const std::size_t size_of_field_key = 1;
+                return size_of_field_key +
+                       static_cast<std::size_t>(protozero::length_of_varint(content_size)) +
+                       content_size;
+            }
+
+            // Append the segments making up this layer to the segments
+            // vector: the pbf field header (which is appended to the
+            // headers buffer first) followed by the views of the layer
+            // content. The headers buffer must not reallocate, reserve
+            // enough space (see serialized_size()) before calling this.
+            void build_segments(std::vector<char>& headers, std::vector<data_view>& segments) const {
+                std::size_t content_size = 0;
+                if (m_data_view.data()) {
+                    content_size = m_data_view.size();
+                } else {
+                    if (m_num_features == 0) {
+                        return; // do not add empty layers
+                    }
+                    content_size = data().size() +
+                                   keys_data().size() +
+                                   values_data().size();
+                }
+
+                const std::size_t header_offset = headers.size();
+                headers.push_back(static_cast<char>(protozero::tag_and_type(detail::pbf_tile::layers, protozero::pbf_wire_type::length_delimited)));
+                protozero::write_varint(std::back_inserter(headers), content_size);
+                segments.emplace_back(headers.data() + header_offset, headers.size() - header_offset);
+
+                if (m_data_view.data()) {
+                    segments.push_back(m_data_view);
+                    return;
+                }
+                for (const auto* str : {&data(), &keys_data(), &values_data()}) {
+                    if (!str->empty()) {
+                        segments.emplace_back(*str);
+                    }
+                }
             }
 
             template <typename TBuffer>
@@ -18,10 +18,224 @@ documentation.
 
 #include "types.hpp"
 
-#include <protozero/pbf_builder.hpp>
+#include <protozero/basic_pbf_builder.hpp>
+#include <protozero/buffer_tmpl.hpp>
 
+#include <algorithm>
+#include <cstring>
 #include <functional>
 #include <string>
+#include <utility>
+
+namespace vtzero {
+
+    namespace detail {
+
+        /**
+         * Byte buffer with a small-buffer optimization used to store
+         * encoded property values. The pbf encoding of all numeric and
+         * boolean values fits into the inline buffer, so creating those
+         * values doesn't allocate any memory. Only strings longer than
+         * the inline capacity go to the heap.
+         */
+        class sbo_buffer {
+
+            // Large enough for the longest numeric encoding (tag byte
+            // plus 10 byte varint) with some room to spare.
+            enum constants : std::size_t {
+                inline_capacity = 23
+            };
+
+            char* m_data;
+            std::size_t m_size = 0;
+            std::size_t m_capacity;
+            char m_inline_data[inline_capacity];
+
+            bool is_inline() const noexcept {
+                return m_data == m_inline_data;
+            }
+
+        public:
+
+            sbo_buffer() noexcept :
+                m_data(m_inline_data),
+                m_capacity(inline_capacity) {
+            }
+
+            ~sbo_buffer() noexcept {
+                if (!is_inline()) {
+                    delete[] m_data;
+                }
+            }
+
+            /// Copy constructor
+            sbo_buffer(const sbo_buffer& other) :
+                sbo_buffer() {
+                append(other.data(), other.size());
+            }
+
+            /// Copy assignment
+            sbo_buffer& operator=(const sbo_buffer& other) {
+                if (this != &other) {
+                    clear();
+                    append(other.data(), other.size());
+                }
+                return *this;
+            }
+
+            /// Move constructor
+            sbo_buffer(sbo_buffer&& other) noexcept :
+                sbo_buffer() {
+                if (other.is_inline()) {
+                    std::memcpy(m_inline_data, other.m_inline_data, other.m_size);
+                } else {
+                    m_data = other.m_data;
+                    m_capacity = other.m_capacity;
+                }
+                m_size = other.m_size;
+                other.m_data = other.m_inline_data;
+                other.m_size = 0;
+                other.m_capacity = inline_capacity;
+            }
+
+            /// Move assignment
+            sbo_buffer& operator=(sbo_buffer&& other) noexcept {
+                if (this != &other) {
+                    if (!is_inline()) {
+                        delete[] m_data;
+                        m_data = m_inline_data;
+                        m_capacity = inline_capacity;
+                    }
+                    if (other.is_inline()) {
+                        std::memcpy(m_inline_data, other.m_inline_data, other.m_size);
+                    } else {
+                        m_data = other.m_data;
+                        m_capacity = other.m_capacity;
+                    }
+                    m_size = other.m_size;
+                    other.m_data = other.m_inline_data;
+                    other.m_size = 0;
+                    other.m_capacity = inline_capacity;
+                }
+                return *this;
+            }
+
+            /// Pointer to the data in this buffer.
+            const char* data() const noexcept {
+                return m_data;
+            }
+
+            /// Pointer to the data in this buffer.
+            char* data() noexcept {
+                return m_data;
+            }
+
+            /// The number of bytes in this buffer.
+            std::size_t size() const noexcept {
+                return m_size;
+            }
+
+            /// Remove the data. The capacity is retained.
+            void clear() noexcept {
+                m_size = 0;
+            }
+
+            /// Make sure the buffer can hold at least size more bytes.
+            void reserve_additional(std::size_t size) {
+                if (m_size + size <= m_capacity) {
+                    return;
+                }
+                const std::size_t new_capacity = std::max(m_capacity * 2, m_size + size);
+                char* new_data = new char[new_capacity];
+                std::memcpy(new_data, m_data, m_size);
+                if (!is_inline()) {
+                    delete[] m_data;
+                }
+                m_data = new_data;
+                m_capacity = new_capacity;
+            }
+
+            /// Append the specified bytes to the buffer.
+            void append(const char* data, std::size_t count) {
+                reserve_additional(count);
+                std::memcpy(m_data + m_size, data, count);
+                m_size += count;
+            }
+
+            /// Append count zero bytes to the buffer.
+            void append_zeros(std::size_t count) {
+                reserve_additional(count);
+                std::memset(m_data + m_size, 0, count);
+                m_size += count;
+            }
+
+            /// Append a single byte to the buffer.
+            void push_back(char ch) {
+                reserve_additional(1);
+                m_data[m_size++] = ch;
+            }
+
+            /// Shrink the buffer to the specified size.
+            void resize(std::size_t size) {
+                vtzero_assert(size <= m_size);
+                m_size = size;
+            }
+
+            /// Remove the bytes in the range [from, to) from the buffer.
+            void erase_range(std::size_t from, std::size_t to) {
+                vtzero_assert(from <= to && to <= m_size);
+                std::memmove(m_data + from, m_data + to, m_size - to);
+                m_size -= to - from;
+            }
+
+        }; // class sbo_buffer
+
+    } // namespace detail
+
+} // namespace vtzero
+
+namespace protozero {
+
+    /// Implementation of the protozero buffer customization points for
+    /// the vtzero::detail::sbo_buffer class.
+    template <>
+    struct buffer_customization<vtzero::detail::sbo_buffer> {
+
+        static std::size_t size(const vtzero::detail::sbo_buffer* buffer) noexcept {
+            return buffer->size();
+        }
+
+        static void append(vtzero::detail::sbo_buffer* buffer, const char* data, std::size_t count) {
+            buffer->append(data, count);
+        }
+
+        static void append_zeros(vtzero::detail::sbo_buffer* buffer, std::size_t count) {
+            buffer->append_zeros(count);
+        }
+
+        static void resize(vtzero::detail::sbo_buffer* buffer, std::size_t size) {
+            buffer->resize(size);
+        }
+
+        static void reserve_additional(vtzero::detail::sbo_buffer* buffer, std::size_t size) {
+            buffer->reserve_additional(size);
+        }
+
+        static void erase_range(vtzero::detail::sbo_buffer* buffer, std::size_t from, std::size_t to) {
+            buffer->erase_range(from, to);
+        }
+
+        static char* at_pos(vtzero::detail::sbo_buffer* buffer, std::size_t pos) {
+            return buffer->data() + pos;
+        }
+
+        static void push_back(vtzero::detail::sbo_buffer* buffer, char ch) {
+            buffer->push_back(ch);
+        }
+
+    }; // struct buffer_customization<vtzero::detail::sbo_buffer>
+
+} // namespace protozero
 
 namespace vtzero {
 
@@ -32,37 +246,37 @@ namespace vtzero {
      */
     class encoded_property_value {
 
-        std::string m_data;
+        detail::sbo_buffer m_data;
 
     public:
 
         /// Construct from vtzero::string_value_type.
         explicit encoded_property_value(string_value_type value) {
-            protozero::pbf_builder<detail::pbf_value> pbf_message_value{m_data};
+            protozero::basic_pbf_builder<detail::sbo_buffer, detail::pbf_value> pbf_message_value{m_data};
             pbf_message_value.add_string(detail::pbf_value::string_value, value.value);
         }
 
         /// Construct from const char*.
         explicit encoded_property_value(const char* value) {
-            protozero::pbf_builder<detail::pbf_value> pbf_message_value{m_data};
+            protozero::basic_pbf_builder<detail::sbo_buffer, detail::pbf_value> pbf_message_value{m_data};
             pbf_message_value.add_string(detail::pbf_value::string_value, value);
         }
 
         /// Construct from const char* and size_t.
         explicit encoded_property_value(const char* value, std::size_t size) {
-            protozero::pbf_builder<detail::pbf_value> pbf_message_value{m_data};
+            protozero::basic_pbf_builder<detail::sbo_buffer, detail::pbf_value> pbf_message_value{m_data};
             pbf_message_value.add_string(detail::pbf_value::string_value, value, size);
         }
 
         /// Construct from std::string.
         explicit encoded_property_value(const std::string& value) {
-            protozero::pbf_builder<detail::pbf_value> pbf_message_value{m_data};
+            protozero::basic_pbf_builder<detail::sbo_buffer, detail::pbf_value> pbf_message_value{m_data};
             pbf_message_value.add_string(detail::pbf_value::string_value, value);
         }
 
         /// Construct from vtzero::data_view.
         explicit encoded_property_value(const data_view& value) {
-            protozero::pbf_builder<detail::pbf_value> pbf_message_value{m_data};
+            protozero::basic_pbf_builder<detail::sbo_buffer, detail::pbf_value> pbf_message_value{m_data};
             pbf_message_value.add_string(detail::pbf_value::string_value, value);
         }
 
@@ -70,13 +284,13 @@ namespace vtzero {
 
         /// Construct from vtzero::float_value_type.
         explicit encoded_property_value(float_value_type value) {
-            protozero::pbf_builder<detail::pbf_value> pbf_message_value{m_data};
+            protozero::basic_pbf_builder<detail::sbo_buffer, detail::pbf_value> pbf_message_value{m_data};
             pbf_message_value.add_float(detail::pbf_value::float_value, value.value);
         }
 
         /// Construct from float.
         explicit encoded_property_value(float value) {
-            protozero::pbf_builder<detail::pbf_value> pbf_message_value{m_data};
+            protozero::basic_pbf_builder<detail::sbo_buffer, detail::pbf_value> pbf_message_value{m_data};
             pbf_message_value.add_float(detail::pbf_value::float_value, value);
         }
 
@@ -84,13 +298,13 @@ namespace vtzero {
 
         /// Construct from vtzero::double_value_type.
         explicit encoded_property_value(double_value_type value) {
-            protozero::pbf_builder<detail::pbf_value> pbf_message_value{m_data};
+            protozero::basic_pbf_builder<detail::sbo_buffer, detail::pbf_value> pbf_message_value{m_data};
             pbf_message_value.add_double(detail::pbf_value::double_value, value.value);
         }
 
         /// Construct from double.
         explicit encoded_property_value(double value) {
-            protozero::pbf_builder<detail::pbf_value> pbf_message_value{m_data};
+            protozero::basic_pbf_builder<detail::sbo_buffer, detail::pbf_value> pbf_message_value{m_data};
             pbf_message_value.add_double(detail::pbf_value::double_value, value);
         }
 
@@ -98,25 +312,25 @@ namespace vtzero {
 
         /// Construct from vtzero::int_value_type.
         explicit encoded_property_value(int_value_type value) {
-            protozero::pbf_builder<detail::pbf_value> pbf_message_value{m_data};
+            protozero::basic_pbf_builder<detail::sbo_buffer, detail::pbf_value> pbf_message_value{m_data};
             pbf_message_value.add_int64(detail::pbf_value::int_value, value.value);
         }
 
         /// Construct from int64_t.
         explicit encoded_property_value(int64_t value) {
-            protozero::pbf_builder<detail::pbf_value> pbf_message_value{m_data};
+            protozero::basic_pbf_builder<detail::sbo_buffer, detail::pbf_value> pbf_message_value{m_data};
             pbf_message_value.add_int64(detail::pbf_value::int_value, value);
         }
 
         /// Construct from int32_t.
         explicit encoded_property_value(int32_t value) {
-            protozero::pbf_builder<detail::pbf_value> pbf_message_value{m_data};
+            protozero::basic_pbf_builder<detail::sbo_buffer, detail::pbf_value> pbf_message_value{m_data};
             pbf_message_value.add_int64(detail::pbf_value::int_value, static_cast<int64_t>(value));
         }
 
         /// Construct from int16_t.
         explicit encoded_property_value(int16_t value) {
-            protozero::pbf_builder<detail::pbf_value> pbf_message_value{m_data};
+            protozero::basic_pbf_builder<detail::sbo_buffer, detail::pbf_value> pbf_message_value{m_data};
             pbf_message_value.add_int64(detail::pbf_value::int_value, static_cast<int64_t>(value));
         }
 
@@ -124,25 +338,25 @@ namespace vtzero {
 
         /// Construct from vtzero::uint_value_type.
         explicit encoded_property_value(uint_value_type value) {
-            protozero::pbf_builder<detail::pbf_value> pbf_message_value{m_data};
+            protozero::basic_pbf_builder<detail::sbo_buffer, detail::pbf_value> pbf_message_value{m_data};
             pbf_message_value.add_uint64(detail::pbf_value::uint_value, value.value);
         }
 
         /// Construct from uint64_t.
         explicit encoded_property_value(uint64_t value) {
-            protozero::pbf_builder<detail::pbf_value> pbf_message_value{m_data};
+            protozero::basic_pbf_builder<detail::sbo_buffer, detail::pbf_value> pbf_message_value{m_data};
             pbf_message_value.add_uint64(detail::pbf_value::uint_value, value);
         }
 
         /// Construct from uint32_t.
         explicit encoded_property_value(uint32_t value) {
-            protozero::pbf_builder<detail::pbf_value> pbf_message_value{m_data};
+            protozero::basic_pbf_builder<detail::sbo_buffer, detail::pbf_value> pbf_message_value{m_data};
             pbf_message_value.add_uint64(detail::pbf_value::uint_value, static_cast<uint64_t>(value));
         }
 
         /// Construct from uint16_t.
         explicit encoded_property_value(uint16_t value) {
-            protozero::pbf_builder<detail::pbf_value> pbf_message_value{m_data};
+            protozero::basic_pbf_builder<detail::sbo_buffer, detail::pbf_value> pbf_message_value{m_data};
             pbf_message_value.add_uint64(detail::pbf_value::uint_value, static_cast<uint64_t>(value));
         }
 
@@ -150,7 +364,7 @@ namespace vtzero {
 
         /// Construct from vtzero::sint_value_type.
         explicit encoded_property_value(sint_value_type value) {
-            protozero::pbf_builder<detail::pbf_value> pbf_message_value{m_data};
+            protozero::basic_pbf_builder<detail::sbo_buffer, detail::pbf_value> pbf_message_value{m_data};
             pbf_message_value.add_sint64(detail::pbf_value::sint_value, value.value);
         }
 
@@ -158,13 +372,13 @@ namespace vtzero {
 
         /// Construct from vtzero::bool_value_type.
         explicit encoded_property_value(bool_value_type value) {
-            protozero::pbf_builder<detail::pbf_value> pbf_message_value{m_data};
+            protozero::basic_pbf_builder<detail::sbo_buffer, detail::pbf_value> pbf_message_value{m_data};
             pbf_message_value.add_bool(detail::pbf_value::bool_value, value.value);
         }
 
         /// Construct from bool.
         explicit encoded_property_value(bool value) {
-            protozero::pbf_builder<detail::pbf_value> pbf_message_value{m_data};
+            protozero::basic_pbf_builder<detail::sbo_buffer, detail::pbf_value> pbf_message_value{m_data};
             pbf_message_value.add_bool(detail::pbf_value::bool_value, value);
         }
 
@@ -181,7 +395,7 @@ namespace vtzero {
          * Hash function compatible with std::hash.
          */
         std::size_t hash() const noexcept {
-            return std::hash<std::string>{}(m_data);
+            return detail::byte_hash(data());
         }
 
     }; // class encoded_property_value
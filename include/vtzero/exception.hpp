@@ -16,6 +16,8 @@ documentation.
  * @brief Contains the exceptions used in the vtzero library.
  */
 
+#include "runtime_stats.hpp"
+
 #include <cstdint>
 #include <stdexcept>
 #include <string>
@@ -32,11 +34,13 @@ namespace vtzero {
         /// Constructor
         explicit exception(const char* message) :
             std::runtime_error(message) {
+            VTZERO_STATS_COUNT(exceptions_thrown);
         }
 
         /// Constructor
         explicit exception(const std::string& message) :
             std::runtime_error(message) {
+            VTZERO_STATS_COUNT(exceptions_thrown);
         }
 
     }; // class exception
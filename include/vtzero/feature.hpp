@@ -19,14 +19,18 @@ documentation.
 #include "exception.hpp"
 #include "property.hpp"
 #include "property_value.hpp"
+#include "runtime_stats.hpp"
 #include "types.hpp"
 
 #include <protozero/pbf_message.hpp>
+#include <protozero/varint.hpp>
 
 #include <cstddef>
 #include <cstdint>
 #include <iterator>
+#include <string>
 #include <utility>
+#include <vector>
 
 namespace vtzero {
 
@@ -43,7 +47,9 @@ namespace vtzero {
         using uint32_it_range = protozero::iterator_range<protozero::pbf_reader::const_uint32_iterator>;
 
         const layer* m_layer = nullptr;
+        data_view m_data{};
         uint64_t m_id = 0; // defaults to 0, see https://github.com/mapbox/vector-tile-spec/blob/master/2.1/vector_tile.proto#L32
+        data_view m_tags{};
         uint32_it_range m_properties{};
         protozero::pbf_reader::const_uint32_iterator m_property_iterator{};
         std::size_t m_num_properties = 0;
@@ -64,7 +70,8 @@ namespace vtzero {
          * @throws format_exception if the layer data is ill-formed.
          */
         feature(const layer* layer, const data_view data) :
-            m_layer(layer) {
+            m_layer(layer),
+            m_data(data) {
             vtzero_assert(layer);
             vtzero_assert(data.data());
 
@@ -80,7 +87,9 @@ namespace vtzero {
                         if (m_properties.begin() != protozero::pbf_reader::const_uint32_iterator{}) {
                             throw format_exception{"Feature has more than one tags field"};
                         }
-                        m_properties = reader.get_packed_uint32();
+                        m_tags = reader.get_view();
+                        m_properties = {protozero::pbf_reader::const_uint32_iterator{m_tags.data(), m_tags.data() + m_tags.size()},
+                                        protozero::pbf_reader::const_uint32_iterator{m_tags.data() + m_tags.size(), m_tags.data() + m_tags.size()}};
                         m_property_iterator = m_properties.begin();
                         break;
                     case protozero::tag_and_type(detail::pbf_feature::type, protozero::pbf_wire_type::varint): {
@@ -113,6 +122,8 @@ namespace vtzero {
                 throw format_exception{"unpaired property key/value indexes (spec 4.4)"};
             }
             m_num_properties = size / 2;
+
+            VTZERO_STATS_COUNT(features_decoded);
         }
 
         /**
@@ -135,6 +146,19 @@ namespace vtzero {
             return valid();
         }
 
+        /**
+         * The raw data of this feature as it is encoded in the layer. This
+         * can be used to copy the feature without decoding it, see
+         * layer_builder::copy_feature().
+         *
+         * Complexity: Constant.
+         *
+         * Always returns an empty data_view for invalid features.
+         */
+        data_view data() const noexcept {
+            return m_data;
+        }
+
         /**
          * The ID of this feature. According to the spec IDs should be unique
          * in a layer if they are set (spec 4.2).
@@ -246,6 +270,37 @@ namespace vtzero {
             m_property_iterator = m_properties.begin();
         }
 
+        /**
+         * Get the property with the specified key.
+         *
+         * The first time this is called on any feature of a layer, a hash
+         * index from property keys to key table slots is built in the layer
+         * and shared by all features of that layer. The lookup itself then
+         * only compares key table indexes while walking over the properties
+         * of this feature, no string comparisons are done and no values are
+         * decoded for properties that don't match.
+         *
+         * This does not use or change the state of the property iterator.
+         *
+         * Complexity: Linear in the number of properties of this feature.
+         *
+         * @param key The property key to look for.
+         * @returns The property with the specified key or the invalid
+         *          property if this feature doesn't have such a property.
+         * @throws out_of_range_exception if the value index of the matching
+         *         property is not valid.
+         * @throws any protozero exception if the protobuf encoding is
+         *         invalid.
+         * @pre @code valid() @endcode
+         */
+        property get_property_by_key(data_view key) const;
+
+        /// @copydoc get_property_by_key(data_view) const
+        property get_property_by_key(const std::string& key) const;
+
+        /// @copydoc get_property_by_key(data_view) const
+        property get_property_by_key(const char* key) const;
+
         /**
          * Call a function for each property of this feature.
          *
@@ -259,6 +314,65 @@ namespace vtzero {
         template <typename TFunc>
         bool for_each_property(TFunc&& func) const;
 
+        /**
+         * Call a function for each property of this feature using a
+         * caller-provided scratch buffer.
+         *
+         * This decodes the whole packed tags array into the scratch vector
+         * in one go (see decode_property_indexes()) and then walks over the
+         * flat array. When iterating over the properties of many features,
+         * reusing the same scratch vector avoids one allocation per feature
+         * and is faster than the plain overload.
+         *
+         * @tparam TFunc The type of the function. It must take a single
+         *         argument of type property&& and return a bool. If the
+         *         function returns false, the iteration will be stopped.
+         * @param func The function to call.
+         * @param scratch Scratch vector used to hold the decoded key/value
+         *        indexes. Any contents are overwritten.
+         * @returns true if the iteration was completed and false otherwise.
+         * @pre @code valid() @endcode
+         */
+        template <typename TFunc>
+        bool for_each_property(TFunc&& func, std::vector<uint32_t>& scratch) const;
+
+        /**
+         * Decode all property key/value indexes of this feature into the
+         * scratch vector in one go. Afterwards the vector contains
+         * alternating key and value indexes into the layer key/value
+         * tables.
+         *
+         * The decode loop is a tight pass over the packed tags array with a
+         * fast path for single-byte varints, which almost all key/value
+         * indexes are in practice.
+         *
+         * Complexity: Linear in the number of properties.
+         *
+         * @param scratch Vector the indexes are decoded into. Any contents
+         *        are overwritten.
+         * @throws any protozero exception if the protobuf encoding is
+         *         invalid.
+         * @pre @code valid() @endcode
+         */
+        void decode_property_indexes(std::vector<uint32_t>& scratch) const {
+            vtzero_assert(valid());
+
+            scratch.clear();
+            scratch.reserve(m_num_properties * 2);
+
+            const char* data = m_tags.data();
+            const char* const end = data + m_tags.size();
+            while (data != end) {
+                const auto value = static_cast<uint8_t>(*data);
+                if (value < 0x80u) {
+                    scratch.push_back(value);
+                    ++data;
+                } else {
+                    scratch.push_back(static_cast<uint32_t>(protozero::decode_varint(&data, end)));
+                }
+            }
+        }
+
         /**
          * Call a function for each key/value index of this feature.
          *
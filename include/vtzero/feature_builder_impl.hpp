@@ -22,6 +22,7 @@ documentation.
 #include "property.hpp"
 #include "property_value.hpp"
 
+#include <cstddef>
 #include <utility>
 
 namespace vtzero {
@@ -82,6 +83,12 @@ namespace vtzero {
                 return m_layer->version();
             }
 
+            // Make sure there is room for at least size more bytes in the
+            // layer's feature buffer without it having to grow.
+            void reserve_additional_impl(const std::size_t size) {
+                m_layer->reserve_additional(size);
+            }
+
             void set_id_impl(uint64_t id) {
                 m_feature_writer.add_uint64(detail::pbf_feature::id, id);
             }
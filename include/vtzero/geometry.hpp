@@ -17,12 +17,17 @@ documentation.
  */
 
 #include "exception.hpp"
+#include "runtime_stats.hpp"
 #include "types.hpp"
 
 #include <protozero/pbf_reader.hpp>
+#include <protozero/varint.hpp>
 
 #include <cstdint>
+#include <iterator>
 #include <limits>
+#include <string>
+#include <type_traits>
 #include <utility>
 
 namespace vtzero {
@@ -79,6 +84,86 @@ namespace vtzero {
         return !(a == b);
     }
 
+    /**
+     * An axis-aligned bounding box in tile coordinates as computed by
+     * decode_bounding_box().
+     */
+    struct bounding_box {
+
+        /// Minimum x and y coordinates
+        point min{std::numeric_limits<int32_t>::max(), std::numeric_limits<int32_t>::max()};
+
+        /// Maximum x and y coordinates
+        point max{std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::min()};
+
+        /**
+         * Is this a valid bounding box? The bounding box of a geometry
+         * without any points is invalid.
+         */
+        bool valid() const noexcept {
+            return min.x <= max.x;
+        }
+
+        /// Extend the bounding box to contain the specified point.
+        void extend(const point p) noexcept {
+            if (p.x < min.x) { min.x = p.x; }
+            if (p.y < min.y) { min.y = p.y; }
+            if (p.x > max.x) { max.x = p.x; }
+            if (p.y > max.y) { max.y = p.y; }
+        }
+
+        /// Does this bounding box contain the specified point?
+        bool contains(const point p) const noexcept {
+            return p.x >= min.x && p.x <= max.x &&
+                   p.y >= min.y && p.y <= max.y;
+        }
+
+    }; // struct bounding_box
+
+    /// Bounding boxes are equal if their corners are
+    inline constexpr bool operator==(const bounding_box& a, const bounding_box& b) noexcept {
+        return a.min == b.min && a.max == b.max;
+    }
+
+    /// Bounding boxes are not equal if their corners aren't
+    inline constexpr bool operator!=(const bounding_box& a, const bounding_box& b) noexcept {
+        return !(a == b);
+    }
+
+    /**
+     * Validation policy for the geometry decoder: Validate that the
+     * geometry conforms to the vector tile spec and throw a
+     * geometry_exception if it doesn't. This is the default.
+     */
+    struct checked {
+
+        /// @cond internal
+        static constexpr bool validate = true;
+        /// @endcond
+
+    }; // struct checked
+
+    /**
+     * Validation policy for the geometry decoder: Trust that the geometry
+     * conforms to the vector tile spec and compile out the conformance
+     * checks on the decoding hot path.
+     *
+     * Only use this for data from a trusted source that was validated
+     * before, for instance at ingest time. Decoding invalid data with this
+     * policy results in undefined behaviour!
+     *
+     * @code
+     * vtzero::decode_geometry<vtzero::trusted>(feature.geometry(), handler);
+     * @endcode
+     */
+    struct trusted {
+
+        /// @cond internal
+        static constexpr bool validate = false;
+        /// @endcond
+
+    }; // struct trusted
+
     namespace detail {
 
         /// The command id type as specified in the vector tile spec
@@ -145,12 +230,41 @@ namespace vtzero {
 
         };
 
+        // Calls geom_handler.ring_end(ring_type, int64_t) if the handler
+        // has such a method, geom_handler.ring_end(ring_type) otherwise.
+        // The second parameter is the shoelace sum of the ring, ie twice
+        // its signed area.
+        template <typename T, typename Enable = void>
+        struct ring_end_caller {
+
+            template <typename TGeomHandler>
+            static void call(TGeomHandler&& geom_handler, const ring_type rt, const int64_t /*twice_area*/) {
+                std::forward<TGeomHandler>(geom_handler).ring_end(rt);
+            }
+
+        };
+
+        template <typename T>
+        struct ring_end_caller<T, typename std::enable_if<std::is_same<decltype(std::declval<T>().ring_end(std::declval<ring_type>(), std::declval<int64_t>())), void>::value>::type> {
+
+            template <typename TGeomHandler>
+            static void call(TGeomHandler&& geom_handler, const ring_type rt, const int64_t twice_area) {
+                std::forward<TGeomHandler>(geom_handler).ring_end(rt, twice_area);
+            }
+
+        };
+
         /**
          * Decode a geometry as specified in spec 4.3 from a sequence of 32 bit
          * unsigned integers. This templated base class can be instantiated
          * with a different iterator type for testing than for normal use.
+         *
+         * The TPolicy template parameter decides whether the decoder
+         * validates that the data conforms to the spec (vtzero::checked,
+         * the default) or trusts the data and compiles out the conformance
+         * checks (vtzero::trusted).
          */
-        template <typename TIterator>
+        template <typename TIterator, typename TPolicy = checked>
         class geometry_decoder {
 
         public:
@@ -175,6 +289,23 @@ namespace vtzero {
              */
             uint32_t m_count = 0;
 
+            /**
+             * Set in next_command() if we know that all points of the
+             * current command are available. In that case next_point()
+             * doesn't need to check for the end of the data on every
+             * point. This can only ever be true for random access
+             * iterators.
+             */
+            bool m_all_points_available = false;
+
+            bool check_all_points_available(std::random_access_iterator_tag) const noexcept {
+                return std::distance(m_it, m_end) >= static_cast<typename std::iterator_traits<iterator_type>::difference_type>(2 * static_cast<std::size_t>(m_count));
+            }
+
+            bool check_all_points_available(std::forward_iterator_tag) const noexcept {
+                return false;
+            }
+
         public:
 
             geometry_decoder(iterator_type begin, iterator_type end, std::size_t max) :
@@ -182,8 +313,48 @@ namespace vtzero {
                 m_end(end),
                 m_max_count(static_cast<uint32_t>(max)) {
                 vtzero_assert(max <= detail::max_command_count());
+                VTZERO_STATS_COUNT(geometries_decoded);
+            }
+
+        private:
+
+            // Bulk decoding fast path: all points of the command run are
+            // known to be available, so the inner loop doesn't need any
+            // per-point checks.
+            void next_points_impl(point* buffer, const uint32_t num_points, std::random_access_iterator_tag) {
+                if (TPolicy::validate && !m_all_points_available) {
+                    // next_command() already found out that the data is
+                    // truncated somewhere in this command.
+                    throw geometry_exception{"too few points in geometry"};
+                }
+
+                for (uint32_t n = 0; n < num_points; ++n) {
+                    // spec 4.3.2 "A ParameterInteger is zigzag encoded"
+                    const int64_t x = m_cursor.x + static_cast<int64_t>(protozero::decode_zigzag32(static_cast<uint32_t>(*m_it++)));
+                    const int64_t y = m_cursor.y + static_cast<int64_t>(protozero::decode_zigzag32(static_cast<uint32_t>(*m_it++)));
+
+                    // The same truncating casts as in next_point(), see
+                    // the comments there.
+                    m_cursor.x = static_cast<int32_t>(x);
+                    m_cursor.y = static_cast<int32_t>(y);
+
+                    buffer[n] = m_cursor;
+                }
+
+                VTZERO_STATS_ADD(points_decoded, num_points);
+                m_count = 0;
             }
 
+            // Scalar fallback used when the iterator can not cheaply tell
+            // us how many elements are left.
+            void next_points_impl(point* buffer, const uint32_t num_points, std::forward_iterator_tag) {
+                for (uint32_t n = 0; n < num_points; ++n) {
+                    buffer[n] = next_point();
+                }
+            }
+
+        public:
+
             uint32_t count() const noexcept {
                 return m_count;
             }
@@ -199,41 +370,61 @@ namespace vtzero {
                     return false;
                 }
 
-                const auto command_id = get_command_id(*m_it);
-                if (command_id != static_cast<uint32_t>(expected_command_id)) {
-                    throw geometry_exception{std::string{"expected command "} +
-                                             std::to_string(static_cast<uint32_t>(expected_command_id)) +
-                                             " but got " +
-                                             std::to_string(command_id)};
+                if (TPolicy::validate) {
+                    const auto command_id = get_command_id(*m_it);
+                    if (command_id != static_cast<uint32_t>(expected_command_id)) {
+                        throw geometry_exception{std::string{"expected command "} +
+                                                 std::to_string(static_cast<uint32_t>(expected_command_id)) +
+                                                 " but got " +
+                                                 std::to_string(command_id)};
+                    }
                 }
 
                 if (expected_command_id == CommandId::CLOSE_PATH) {
                     // spec 4.3.3.3 "A ClosePath command MUST have a command count of 1"
-                    if (get_command_count(*m_it) != 1) {
+                    if (TPolicy::validate && get_command_count(*m_it) != 1) {
                         throw geometry_exception{"ClosePath command count is not 1"};
                     }
                 } else {
                     m_count = get_command_count(*m_it);
-                    if (m_count > m_max_count) {
+                    if (TPolicy::validate && m_count > m_max_count) {
                         throw geometry_exception{"count too large"};
                     }
                 }
 
                 ++m_it;
 
+                if (m_count > 0) {
+                    // If we can check here that all points of this command
+                    // are available, next_point() doesn't have to check
+                    // again on every point.
+                    m_all_points_available = check_all_points_available(
+                        typename std::iterator_traits<iterator_type>::iterator_category{});
+                }
+
                 return true;
             }
 
             point next_point() {
                 vtzero_assert(m_count > 0);
 
-                if (m_it == m_end || std::next(m_it) == m_end) {
-                    throw geometry_exception{"too few points in geometry"};
-                }
+                int64_t x = 0;
+                int64_t y = 0;
 
-                // spec 4.3.2 "A ParameterInteger is zigzag encoded"
-                int64_t x = protozero::decode_zigzag32(*m_it++);
-                int64_t y = protozero::decode_zigzag32(*m_it++);
+                if (m_all_points_available || !TPolicy::validate) {
+                    // spec 4.3.2 "A ParameterInteger is zigzag encoded"
+                    x = protozero::decode_zigzag32(*m_it++);
+                    y = protozero::decode_zigzag32(*m_it++);
+                } else {
+                    if (m_it == m_end) {
+                        throw geometry_exception{"too few points in geometry"};
+                    }
+                    x = protozero::decode_zigzag32(*m_it++);
+                    if (m_it == m_end) {
+                        throw geometry_exception{"too few points in geometry"};
+                    }
+                    y = protozero::decode_zigzag32(*m_it++);
+                }
 
                 // x and y are int64_t so this addition can never overflow
                 x += m_cursor.x;
@@ -247,18 +438,48 @@ namespace vtzero {
 
                 --m_count;
 
+                VTZERO_STATS_COUNT(points_decoded);
                 return m_cursor;
             }
 
+            /**
+             * Decode all remaining points of the current command in one go
+             * and write them to the specified buffer.
+             *
+             * For random access iterators (ie. when the geometry data was
+             * already decoded into a container of 32 bit unsigned integers)
+             * the availability of all points is checked once for the whole
+             * command run, so the inner decoding loop can run without
+             * per-point branches. For other iterators this falls back to
+             * the normal per-point decoding.
+             *
+             * @param buffer Pointer to a buffer with room for at least
+             *        count() points.
+             * @returns The number of points written to the buffer.
+             * @throws geometry_exception if the data is truncated.
+             * @pre @code count() > 0 @endcode
+             */
+            uint32_t next_points(point* buffer) {
+                vtzero_assert(m_count > 0);
+
+                const uint32_t num_points = m_count;
+                next_points_impl(buffer, num_points,
+                                 typename std::iterator_traits<iterator_type>::iterator_category{});
+                vtzero_assert_in_noexcept_function(m_count == 0);
+
+                return num_points;
+            }
+
             template <typename TGeomHandler>
             typename detail::get_result<TGeomHandler>::type decode_point(TGeomHandler&& geom_handler) {
                 // spec 4.3.4.2 "MUST consist of a single MoveTo command"
-                if (!next_command(CommandId::MOVE_TO)) {
+                const bool has_move_to = next_command(CommandId::MOVE_TO);
+                if (TPolicy::validate && !has_move_to) {
                     throw geometry_exception{"expected MoveTo command (spec 4.3.4.2)"};
                 }
 
                 // spec 4.3.4.2 "command count greater than 0"
-                if (count() == 0) {
+                if (TPolicy::validate && count() == 0) {
                     throw geometry_exception{"MoveTo command count is zero (spec 4.3.4.2)"};
                 }
 
@@ -268,7 +489,7 @@ namespace vtzero {
                 }
 
                 // spec 4.3.4.2 "MUST consist of of a single ... command"
-                if (!done()) {
+                if (TPolicy::validate && !done()) {
                     throw geometry_exception{"additional data after end of geometry (spec 4.3.4.2)"};
                 }
 
@@ -282,19 +503,20 @@ namespace vtzero {
                 // spec 4.3.4.3 "1. A MoveTo command"
                 while (next_command(CommandId::MOVE_TO)) {
                     // spec 4.3.4.3 "with a command count of 1"
-                    if (count() != 1) {
+                    if (TPolicy::validate && count() != 1) {
                         throw geometry_exception{"MoveTo command count is not 1 (spec 4.3.4.3)"};
                     }
 
                     const auto first_point = next_point();
 
                     // spec 4.3.4.3 "2. A LineTo command"
-                    if (!next_command(CommandId::LINE_TO)) {
+                    const bool has_line_to = next_command(CommandId::LINE_TO);
+                    if (TPolicy::validate && !has_line_to) {
                         throw geometry_exception{"expected LineTo command (spec 4.3.4.3)"};
                     }
 
                     // spec 4.3.4.3 "with a command count greater than 0"
-                    if (count() == 0) {
+                    if (TPolicy::validate && count() == 0) {
                         throw geometry_exception{"LineTo command count is zero (spec 4.3.4.3)"};
                     }
 
@@ -316,7 +538,7 @@ namespace vtzero {
                 // spec 4.3.4.4 "1. A MoveTo command"
                 while (next_command(CommandId::MOVE_TO)) {
                     // spec 4.3.4.4 "with a command count of 1"
-                    if (count() != 1) {
+                    if (TPolicy::validate && count() != 1) {
                         throw geometry_exception{"MoveTo command count is not 1 (spec 4.3.4.4)"};
                     }
 
@@ -325,7 +547,8 @@ namespace vtzero {
                     point last_point = start_point;
 
                     // spec 4.3.4.4 "2. A LineTo command"
-                    if (!next_command(CommandId::LINE_TO)) {
+                    const bool has_line_to = next_command(CommandId::LINE_TO);
+                    if (TPolicy::validate && !has_line_to) {
                         throw geometry_exception{"expected LineTo command (spec 4.3.4.4)"};
                     }
 
@@ -341,7 +564,8 @@ namespace vtzero {
                     }
 
                     // spec 4.3.4.4 "3. A ClosePath command"
-                    if (!next_command(CommandId::CLOSE_PATH)) {
+                    const bool has_close_path = next_command(CommandId::CLOSE_PATH);
+                    if (TPolicy::validate && !has_close_path) {
                         throw geometry_exception{"expected ClosePath command (spec 4.3.4.4)"};
                     }
 
@@ -349,8 +573,11 @@ namespace vtzero {
 
                     geom_handler.ring_point(start_point);
 
-                    geom_handler.ring_end(sum > 0 ? ring_type::outer :
-                                                    sum < 0 ? ring_type::inner : ring_type::invalid);
+                    detail::ring_end_caller<typename std::remove_reference<TGeomHandler>::type>::call(
+                        geom_handler,
+                        sum > 0 ? ring_type::outer :
+                        sum < 0 ? ring_type::inner : ring_type::invalid,
+                        sum);
                 }
 
                 return detail::get_result<TGeomHandler>{}(std::forward<TGeomHandler>(geom_handler));
@@ -363,22 +590,26 @@ namespace vtzero {
     /**
      * Decode a point geometry.
      *
+     * @tparam TPolicy The validation policy, vtzero::checked (default) or
+     *         vtzero::trusted.
      * @tparam TGeomHandler Handler class. See tutorial for details.
      * @param geometry The geometry as returned by feature.geometry().
      * @param geom_handler An object of TGeomHandler.
      * @throws geometry_error If there is a problem with the geometry.
      * @pre Geometry must be a point geometry.
      */
-    template <typename TGeomHandler>
+    template <typename TPolicy = checked, typename TGeomHandler>
     typename detail::get_result<TGeomHandler>::type decode_point_geometry(const geometry& geometry, TGeomHandler&& geom_handler) {
         vtzero_assert(geometry.type() == GeomType::POINT);
-        detail::geometry_decoder<decltype(geometry.begin())> decoder{geometry.begin(), geometry.end(), geometry.data().size() / 2};
+        detail::geometry_decoder<decltype(geometry.begin()), TPolicy> decoder{geometry.begin(), geometry.end(), geometry.data().size() / 2};
         return decoder.decode_point(std::forward<TGeomHandler>(geom_handler));
     }
 
     /**
      * Decode a linestring geometry.
      *
+     * @tparam TPolicy The validation policy, vtzero::checked (default) or
+     *         vtzero::trusted.
      * @tparam TGeomHandler Handler class. See tutorial for details.
      * @param geometry The geometry as returned by feature.geometry().
      * @param geom_handler An object of TGeomHandler.
@@ -387,16 +618,18 @@ namespace vtzero {
      * @throws geometry_error If there is a problem with the geometry.
      * @pre Geometry must be a linestring geometry.
      */
-    template <typename TGeomHandler>
+    template <typename TPolicy = checked, typename TGeomHandler>
     typename detail::get_result<TGeomHandler>::type decode_linestring_geometry(const geometry& geometry, TGeomHandler&& geom_handler) {
         vtzero_assert(geometry.type() == GeomType::LINESTRING);
-        detail::geometry_decoder<decltype(geometry.begin())> decoder{geometry.begin(), geometry.end(), geometry.data().size() / 2};
+        detail::geometry_decoder<decltype(geometry.begin()), TPolicy> decoder{geometry.begin(), geometry.end(), geometry.data().size() / 2};
         return decoder.decode_linestring(std::forward<TGeomHandler>(geom_handler));
     }
 
     /**
      * Decode a polygon geometry.
      *
+     * @tparam TPolicy The validation policy, vtzero::checked (default) or
+     *         vtzero::trusted.
      * @tparam TGeomHandler Handler class. See tutorial for details.
      * @param geometry The geometry as returned by feature.geometry().
      * @param geom_handler An object of TGeomHandler.
@@ -404,17 +637,26 @@ namespace vtzero {
      *          void otherwise
      * @throws geometry_error If there is a problem with the geometry.
      * @pre Geometry must be a polygon geometry.
+     *
+     * @note The ring_end() method of the handler can optionally take a
+     *       second parameter of type int64_t which is set to the shoelace
+     *       sum of the ring, ie twice its signed area (positive for outer
+     *       rings, negative for inner rings). The decoder computes this
+     *       sum anyway to classify the ring, handlers that need the ring
+     *       area (for instance for tessellation) get it for free this way.
      */
-    template <typename TGeomHandler>
+    template <typename TPolicy = checked, typename TGeomHandler>
     typename detail::get_result<TGeomHandler>::type decode_polygon_geometry(const geometry& geometry, TGeomHandler&& geom_handler) {
         vtzero_assert(geometry.type() == GeomType::POLYGON);
-        detail::geometry_decoder<decltype(geometry.begin())> decoder{geometry.begin(), geometry.end(), geometry.data().size() / 2};
+        detail::geometry_decoder<decltype(geometry.begin()), TPolicy> decoder{geometry.begin(), geometry.end(), geometry.data().size() / 2};
         return decoder.decode_polygon(std::forward<TGeomHandler>(geom_handler));
     }
 
     /**
      * Decode a geometry.
      *
+     * @tparam TPolicy The validation policy, vtzero::checked (default) or
+     *         vtzero::trusted.
      * @tparam TGeomHandler Handler class. See tutorial for details.
      * @param geometry The geometry as returned by feature.geometry().
      * @param geom_handler An object of TGeomHandler.
@@ -423,9 +665,9 @@ namespace vtzero {
      * @throws geometry_error If the geometry has type UNKNOWN of if there is
      *                        a problem with the geometry.
      */
-    template <typename TGeomHandler>
+    template <typename TPolicy = checked, typename TGeomHandler>
     typename detail::get_result<TGeomHandler>::type decode_geometry(const geometry& geometry, TGeomHandler&& geom_handler) {
-        detail::geometry_decoder<decltype(geometry.begin())> decoder{geometry.begin(), geometry.end(), geometry.data().size() / 2};
+        detail::geometry_decoder<decltype(geometry.begin()), TPolicy> decoder{geometry.begin(), geometry.end(), geometry.data().size() / 2};
         switch (geometry.type()) {
             case GeomType::POINT:
                 return decoder.decode_point(std::forward<TGeomHandler>(geom_handler));
@@ -439,6 +681,217 @@ namespace vtzero {
         throw geometry_exception{"unknown geometry type"};
     }
 
+    /**
+     * Statistics about a geometry as computed by geometry_stats().
+     */
+    struct geometry_statistics {
+
+        /// Total number of points in the geometry.
+        uint64_t num_points = 0;
+
+        /**
+         * Number of parts, ie the number of MoveTo commands. This is the
+         * number of rings for polygon geometries and the number of
+         * linestrings for linestring geometries. Note that a multipoint
+         * geometry has a single MoveTo command and so counts as one part.
+         */
+        uint64_t num_parts = 0;
+
+        /**
+         * Number of points in the longest part. Note that when decoding a
+         * polygon geometry each ring gets one additional (repeated) point
+         * from the ClosePath command.
+         */
+        uint64_t longest_part = 0;
+
+    }; // struct geometry_statistics
+
+    /**
+     * Compute statistics about a geometry from a scan over the command
+     * integers only. The parameter varints are skipped, never
+     * zigzag-decoded, which makes this much cheaper than running a
+     * counting handler through a full decode.
+     *
+     * Use this to reserve the exact buffer sizes before the real decode.
+     *
+     * Works for all geometry types.
+     *
+     * @param geometry The geometry as returned by feature.geometry().
+     * @returns The statistics for this geometry.
+     * @throws geometry_exception If there is a problem with the geometry.
+     * @throws any protozero exception if the encoding is invalid.
+     */
+    inline geometry_statistics geometry_stats(const geometry& geometry) {
+        geometry_statistics stats{};
+
+        const char* data = geometry.data().data();
+        const char* const end = data + geometry.data().size();
+
+        uint64_t current_part = 0;
+        while (data != end) {
+            const auto command = static_cast<uint32_t>(protozero::decode_varint(&data, end));
+
+            const auto command_id = detail::get_command_id(command);
+            if (command_id == static_cast<uint32_t>(detail::CommandId::CLOSE_PATH)) {
+                continue;
+            }
+
+            const auto count = detail::get_command_count(command);
+            if (command_id == static_cast<uint32_t>(detail::CommandId::MOVE_TO)) {
+                if (current_part > stats.longest_part) {
+                    stats.longest_part = current_part;
+                }
+                current_part = count;
+                ++stats.num_parts;
+            } else if (command_id == static_cast<uint32_t>(detail::CommandId::LINE_TO)) {
+                current_part += count;
+            } else {
+                throw geometry_exception{"unknown command in geometry"};
+            }
+
+            stats.num_points += count;
+            for (auto n = count * 2; n > 0; --n) {
+                if (data == end) {
+                    throw geometry_exception{"too few points in geometry"};
+                }
+                protozero::skip_varint(&data, end);
+            }
+        }
+
+        if (current_part > stats.longest_part) {
+            stats.longest_part = current_part;
+        }
+
+        return stats;
+    }
+
+    /**
+     * Compute the bounding box of a geometry without decoding it through
+     * a geometry handler.
+     *
+     * This is a specialized pass over the command stream that only tracks
+     * the minimum and maximum of the running cursor: no handler calls, no
+     * ring winding math. Use it in spatial filter stages that reject
+     * features against a viewport before doing the full geometry decode.
+     *
+     * Works for all geometry types.
+     *
+     * @param geometry The geometry as returned by feature.geometry().
+     * @returns The bounding box of the geometry. For an empty geometry an
+     *          invalid bounding box is returned.
+     * @throws geometry_exception If there is a problem with the geometry.
+     * @throws any protozero exception if the encoding is invalid.
+     */
+    inline bounding_box decode_bounding_box(const geometry& geometry) {
+        bounding_box bbox{};
+
+        const char* data = geometry.data().data();
+        const char* const end = data + geometry.data().size();
+
+        point cursor{};
+        while (data != end) {
+            const auto command = static_cast<uint32_t>(protozero::decode_varint(&data, end));
+
+            const auto command_id = detail::get_command_id(command);
+            if (command_id == static_cast<uint32_t>(detail::CommandId::CLOSE_PATH)) {
+                continue;
+            }
+            if (command_id != static_cast<uint32_t>(detail::CommandId::MOVE_TO) &&
+                command_id != static_cast<uint32_t>(detail::CommandId::LINE_TO)) {
+                throw geometry_exception{"unknown command in geometry"};
+            }
+
+            for (auto count = detail::get_command_count(command); count > 0; --count) {
+                if (end - data < 2) {
+                    throw geometry_exception{"too few points in geometry"};
+                }
+
+                // The same truncating casts as in the geometry decoder.
+                cursor.x = static_cast<int32_t>(cursor.x + static_cast<int64_t>(protozero::decode_zigzag32(static_cast<uint32_t>(protozero::decode_varint(&data, end)))));
+                cursor.y = static_cast<int32_t>(cursor.y + static_cast<int64_t>(protozero::decode_zigzag32(static_cast<uint32_t>(protozero::decode_varint(&data, end)))));
+
+                bbox.extend(cursor);
+            }
+        }
+
+        return bbox;
+    }
+
+    /**
+     * Transform a geometry with an affine integer transform
+     *
+     * @code
+     * x' = x * scale + dx
+     * y' = y * scale + dy
+     * @endcode
+     *
+     * without going through a geometry handler. Because such a transform
+     * doesn't change the structure of the encoded command stream, the
+     * stream is rewritten directly in one pass: command integers are
+     * copied and the zigzag-encoded parameters are scaled (and, for the
+     * first point, translated). No point is ever materialized, which
+     * makes this much cheaper than decoding through a geometry handler
+     * and re-encoding through a feature builder. The typical use case is
+     * overzooming tiles.
+     *
+     * The resulting data describes a geometry of the same type and can be
+     * added to a feature with geometry_feature_builder::set_geometry().
+     *
+     * Note that no clipping is done, the transformed coordinates can lie
+     * outside the tile extent.
+     *
+     * @param geometry The geometry as returned by feature.geometry().
+     * @param scale The scale factor. Must be larger than 0.
+     * @param dx Translation in x direction, applied after scaling.
+     * @param dy Translation in y direction, applied after scaling.
+     * @param output Buffer the transformed command stream is appended to.
+     * @throws geometry_exception If there is a problem with the geometry.
+     * @throws any protozero exception if the encoding is invalid.
+     */
+    inline void transform_geometry(const geometry& geometry, const int32_t scale, const int32_t dx, const int32_t dy, std::string& output) {
+        vtzero_assert(scale > 0);
+
+        const char* data = geometry.data().data();
+        const char* const end = data + geometry.data().size();
+        auto out = std::back_inserter(output);
+
+        bool is_first_point = true;
+        while (data != end) {
+            const auto command = static_cast<uint32_t>(protozero::decode_varint(&data, end));
+            protozero::write_varint(out, command);
+
+            const auto command_id = detail::get_command_id(command);
+            if (command_id == static_cast<uint32_t>(detail::CommandId::CLOSE_PATH)) {
+                continue;
+            }
+            if (command_id != static_cast<uint32_t>(detail::CommandId::MOVE_TO) &&
+                command_id != static_cast<uint32_t>(detail::CommandId::LINE_TO)) {
+                throw geometry_exception{"unknown command in geometry"};
+            }
+
+            for (auto count = detail::get_command_count(command); count > 0; --count) {
+                if (end - data < 2) {
+                    throw geometry_exception{"too few points in geometry"};
+                }
+
+                int64_t x = protozero::decode_zigzag32(static_cast<uint32_t>(protozero::decode_varint(&data, end)));
+                int64_t y = protozero::decode_zigzag32(static_cast<uint32_t>(protozero::decode_varint(&data, end)));
+
+                x *= scale;
+                y *= scale;
+
+                if (is_first_point) {
+                    x += dx;
+                    y += dy;
+                    is_first_point = false;
+                }
+
+                protozero::write_varint(out, protozero::encode_zigzag32(static_cast<int32_t>(x)));
+                protozero::write_varint(out, protozero::encode_zigzag32(static_cast<int32_t>(y)));
+            }
+        }
+    }
+
 } // namespace vtzero
 
 #endif // VTZERO_GEOMETRY_HPP
@@ -20,25 +20,219 @@ documentation.
 #include "types.hpp"
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
+#include <functional>
+#include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace vtzero {
 
+    namespace detail {
+
+        // Everything convertible to a data_view (std::string, data_view
+        // itself) is hashed by its bytes, so probing a map with
+        // std::string keys using a data_view gives the same hash. All
+        // other types use std::hash.
+        template <typename T, typename std::enable_if<std::is_convertible<const T&, data_view>::value, int>::type = 0>
+        std::size_t index_hash(const T& value) noexcept {
+            return byte_hash(data_view{value});
+        }
+
+        template <typename T, typename std::enable_if<!std::is_convertible<const T&, data_view>::value, int>::type = 0>
+        std::size_t index_hash(const T& value) {
+            return std::hash<T>{}(value);
+        }
+
+        template <typename TA, typename TB, typename std::enable_if<std::is_convertible<const TA&, data_view>::value &&
+                                                                    std::is_convertible<const TB&, data_view>::value, int>::type = 0>
+        bool index_equal(const TA& a, const TB& b) noexcept {
+            return data_view{a} == data_view{b};
+        }
+
+        template <typename TA, typename TB, typename std::enable_if<!std::is_convertible<const TA&, data_view>::value ||
+                                                                    !std::is_convertible<const TB&, data_view>::value, int>::type = 0>
+        bool index_equal(const TA& a, const TB& b) {
+            return a == b;
+        }
+
+        // Forward reserve() to the map if the map type has it (flat_map,
+        // std::unordered_map), do nothing for maps which don't (std::map).
+        template <typename TMap>
+        auto map_reserve(TMap& map, const std::size_t size, int) -> decltype(map.reserve(size)) {
+            return map.reserve(size);
+        }
+
+        template <typename TMap>
+        void map_reserve(TMap& /*map*/, const std::size_t /*size*/, long) {
+        }
+
+    } // namespace detail
+
+    /**
+     * A simple open-addressing hash map used as the default map type of
+     * the index classes in this file. The entries are stored in one
+     * contiguous vector, a separate slot table with linear probing points
+     * into it, which is more cache-friendly than the node-based standard
+     * maps.
+     *
+     * Only the small part of the std::unordered_map interface needed by
+     * the index classes is supported: find(), emplace(), end(), and
+     * size(). Unlike std::unordered_map, find() accepts any type that can
+     * be hashed and compared with the key type, so a map with std::string
+     * keys can be probed with a data_view without allocating a string.
+     */
+    template <typename TKey, typename TValue, typename... /*unused*/>
+    class flat_map {
+
+    public:
+
+        /// The entry type of this map.
+        using value_type = std::pair<TKey, TValue>;
+
+        /// Iterators are plain pointers into the entries.
+        using iterator = value_type*;
+
+    private:
+
+        // All entries in insertion order.
+        std::vector<value_type> m_entries;
+
+        // The hash table with linear probing: 0 marks an empty slot,
+        // everything else is the index into m_entries plus one. The size
+        // is always a power of two.
+        std::vector<uint32_t> m_slots;
+
+        template <typename T>
+        std::size_t find_slot(const T& key) const noexcept {
+            const std::size_t mask = m_slots.size() - 1;
+            std::size_t pos = detail::index_hash(key) & mask;
+            while (m_slots[pos] != 0 &&
+                   !detail::index_equal(m_entries[m_slots[pos] - 1].first, key)) {
+                pos = (pos + 1) & mask;
+            }
+            return pos;
+        }
+
+        void rehash(const std::size_t new_size) {
+            m_slots.assign(new_size, 0);
+            uint32_t n = 0;
+            for (const auto& entry : m_entries) {
+                m_slots[find_slot(entry.first)] = ++n;
+            }
+        }
+
+        void grow() {
+            rehash(m_slots.empty() ? 16 : m_slots.size() * 2);
+        }
+
+    public:
+
+        flat_map() = default;
+
+        /**
+         * Reserve space for at least the specified number of entries, so
+         * neither the entries vector nor the slot table have to grow
+         * while they are filled up to this size.
+         *
+         * @param size The expected number of entries.
+         */
+        void reserve(const std::size_t size) {
+            m_entries.reserve(size);
+            std::size_t slots_size = m_slots.empty() ? 16 : m_slots.size();
+            while ((size + 1) * 4 > slots_size * 3) {
+                slots_size *= 2;
+            }
+            if (slots_size != m_slots.size()) {
+                rehash(slots_size);
+            }
+        }
+
+        /// The number of entries in the map.
+        std::size_t size() const noexcept {
+            return m_entries.size();
+        }
+
+        /// The past-the-end iterator, only useful to compare against.
+        iterator end() noexcept {
+            return m_entries.data() + m_entries.size();
+        }
+
+        /**
+         * Find the entry with the specified key.
+         *
+         * @tparam T The type of the key to probe with. Doesn't have to be
+         *         TKey as long as it can be hashed and compared with it.
+         * @param key The key to look for.
+         * @returns Iterator to the entry found or end().
+         */
+        template <typename T>
+        iterator find(const T& key) noexcept {
+            if (m_entries.empty()) {
+                return end();
+            }
+            const auto slot = m_slots[find_slot(key)];
+            return slot != 0 ? &m_entries[slot - 1] : end();
+        }
+
+        /**
+         * Add an entry to the map if there is no entry with this key yet.
+         *
+         * @param key The key of the entry.
+         * @param value The value of the entry.
+         */
+        template <typename TK, typename TV>
+        void emplace(TK&& key, TV&& value) {
+            if ((m_entries.size() + 1) * 4 > m_slots.size() * 3) {
+                grow();
+            }
+            const auto pos = find_slot(key);
+            if (m_slots[pos] != 0) {
+                return; // already in the map
+            }
+            m_entries.emplace_back(TKey(std::forward<TK>(key)), std::forward<TV>(value));
+            m_slots[pos] = static_cast<uint32_t>(m_entries.size());
+        }
+
+    }; // class flat_map
+
     /**
      * Used to store the mapping between property keys and the index value
      * in the table stored in a layer.
      *
-     * @tparam TMap The map class to use (std::map, std::unordered_map or
-     *         something compatible).
+     * @tparam TMap The map class to use. Defaults to vtzero::flat_map,
+     *         std::map, std::unordered_map, or something compatible works,
+     *         too.
      */
-    template <template <typename...> class TMap>
+    template <template <typename...> class TMap = flat_map>
     class key_index {
 
         layer_builder& m_builder;
 
         TMap<std::string, index_value> m_index;
 
+        // Last-hit memo: bulk input is often grouped by key, so the same
+        // key repeats for many consecutive calls. Checking the previous
+        // key before probing the map makes this common case a single
+        // byte compare.
+        std::string m_last_key;
+        index_value m_last_index{};
+
+        // Probe the map with the data_view directly if the map supports
+        // heterogeneous lookup, only fall back to constructing a
+        // std::string for the standard maps which don't.
+        template <typename T>
+        static auto map_find(T& map, const data_view key, int) -> decltype(map.find(key)) {
+            return map.find(key);
+        }
+
+        template <typename T>
+        static auto map_find(T& map, const data_view key, long) -> decltype(map.begin()) {
+            return map.find(std::string(key));
+        }
+
     public:
 
         /**
@@ -59,14 +253,32 @@ namespace vtzero {
          * @returns The index value of they key.
          */
         index_value operator()(const data_view key) {
-            std::string text(key);
-            const auto it = m_index.find(text);
+            if (m_last_index.valid() && data_view{m_last_key} == key) {
+                return m_last_index;
+            }
+
+            auto idx = index_value{};
+            const auto it = map_find(m_index, key, 0);
             if (it == m_index.end()) {
-                const auto idx = m_builder.add_key_without_dup_check(key);
-                m_index.emplace(std::move(text), idx);
-                return idx;
+                idx = m_builder.add_key_without_dup_check(key);
+                m_index.emplace(std::string(key), idx);
+            } else {
+                idx = it->second;
             }
-            return it->second;
+
+            m_last_key.assign(key.data(), key.size());
+            m_last_index = idx;
+            return idx;
+        }
+
+        /**
+         * Reserve space for at least the specified number of keys in the
+         * underlying map (if the map type supports that).
+         *
+         * @param size The expected number of distinct keys.
+         */
+        void reserve(const std::size_t size) {
+            detail::map_reserve(m_index, size, 0);
         }
 
     }; // class key_index
@@ -81,16 +293,21 @@ namespace vtzero {
      * @tparam TInternal The type used in the vector tile to encode the value.
      *         Must be one of string/float/double/int/uint/sint/bool_value_type.
      * @tparam TExternal The type for the value used by the user of this class.
-     * @tparam TMap The map class to use (std::map, std::unordered_map or
-     *         something compatible).
+     * @tparam TMap The map class to use. Defaults to vtzero::flat_map,
+     *         std::map, std::unordered_map, or something compatible works,
+     *         too.
      */
-    template <typename TInternal, typename TExternal, template <typename...> class TMap>
+    template <typename TInternal, typename TExternal, template <typename...> class TMap = flat_map>
     class value_index {
 
         layer_builder& m_builder;
 
         TMap<TExternal, index_value> m_index;
 
+        // Last-hit memo, see key_index for the rationale.
+        TExternal m_last_value{};
+        index_value m_last_index{};
+
     public:
 
         /**
@@ -111,13 +328,32 @@ namespace vtzero {
          * @returns The index value of they value.
          */
         index_value operator()(const TExternal& value) {
+            if (m_last_index.valid() && m_last_value == value) {
+                return m_last_index;
+            }
+
+            auto idx = index_value{};
             const auto it = m_index.find(value);
             if (it == m_index.end()) {
-                const auto idx = m_builder.add_value_without_dup_check(encoded_property_value{TInternal{value}});
+                idx = m_builder.add_value_without_dup_check(encoded_property_value{TInternal{value}});
                 m_index.emplace(value, idx);
-                return idx;
+            } else {
+                idx = it->second;
             }
-            return it->second;
+
+            m_last_value = value;
+            m_last_index = idx;
+            return idx;
+        }
+
+        /**
+         * Reserve space for at least the specified number of values in
+         * the underlying map (if the map type supports that).
+         *
+         * @param size The expected number of distinct values.
+         */
+        void reserve(const std::size_t size) {
+            detail::map_reserve(m_index, size, 0);
         }
 
     }; // class value_index
@@ -218,16 +454,22 @@ namespace vtzero {
      * encoded form. This is simpler to use than the value_index class, but
      * has a higher overhead.
      *
-     * @tparam TMap The map class to use (std::map, std::unordered_map or
-     *         something compatible).
+     * @tparam TMap The map class to use. Defaults to vtzero::flat_map,
+     *         std::map, std::unordered_map, or something compatible works,
+     *         too.
      */
-    template <template <typename...> class TMap>
+    template <template <typename...> class TMap = flat_map>
     class value_index_internal {
 
         layer_builder& m_builder;
 
         TMap<encoded_property_value, index_value> m_index;
 
+        // Last-hit memo (stores the encoded bytes of the last value),
+        // see key_index for the rationale.
+        std::string m_last_value;
+        index_value m_last_index{};
+
     public:
 
         /**
@@ -248,17 +490,205 @@ namespace vtzero {
          * @returns The index value of they value.
          */
         index_value operator()(const encoded_property_value& value) {
+            if (m_last_index.valid() && data_view{m_last_value} == value.data()) {
+                return m_last_index;
+            }
+
+            auto idx = index_value{};
             const auto it = m_index.find(value);
             if (it == m_index.end()) {
-                const auto idx = m_builder.add_value_without_dup_check(value);
+                idx = m_builder.add_value_without_dup_check(value);
                 m_index.emplace(value, idx);
-                return idx;
+            } else {
+                idx = it->second;
             }
-            return it->second;
+
+            m_last_value.assign(value.data().data(), value.data().size());
+            m_last_index = idx;
+            return idx;
+        }
+
+        /**
+         * Reserve space for at least the specified number of values in
+         * the underlying map (if the map type supports that).
+         *
+         * @param size The expected number of distinct values.
+         */
+        void reserve(const std::size_t size) {
+            detail::map_reserve(m_index, size, 0);
         }
 
     }; // class value_index_internal
 
+    /**
+     * A pool of strings shared by all layers of a tile (or several
+     * tiles). Each distinct string is hashed and stored only once, no
+     * matter how many layers use it, and gets a dense pool id. Use this
+     * together with the pooled_key_index and pooled_value_index classes
+     * when the layers of your tiles share many property keys or values.
+     */
+    class string_pool {
+
+        flat_map<std::string, index_value> m_index;
+
+    public:
+
+        /**
+         * Get the pool id for the specified string. If the string was not
+         * in the pool, it will be added.
+         *
+         * @param text The string.
+         * @returns The pool id of this string.
+         */
+        index_value id(const data_view text) {
+            const auto it = m_index.find(text);
+            if (it == m_index.end()) {
+                const index_value pool_id{static_cast<uint32_t>(m_index.size())};
+                m_index.emplace(std::string(text), pool_id);
+                return pool_id;
+            }
+            return it->second;
+        }
+
+        /// The number of distinct strings in the pool.
+        std::size_t size() const noexcept {
+            return m_index.size();
+        }
+
+    }; // class string_pool
+
+    /**
+     * Used to store the mapping between property keys and the index value
+     * in the table stored in a layer, like key_index, but backed by a
+     * string_pool shared between layers. The hashing happens once per
+     * distinct key in the pool, per layer only a vector indexed by the
+     * pool id is needed.
+     *
+     * @code
+     *   vtzero::tile_builder tbuilder;
+     *   vtzero::string_pool pool;
+     *   for (...) { // for each layer
+     *     vtzero::layer_builder lbuilder{tbuilder, ...};
+     *     vtzero::pooled_key_index index{lbuilder, pool};
+     *     ...
+     *     fbuilder.add_property(index("name"), ...);
+     *   }
+     * @endcode
+     */
+    class pooled_key_index {
+
+        layer_builder& m_builder;
+
+        string_pool& m_pool;
+
+        // Maps pool ids to the key table index of this layer.
+        std::vector<index_value> m_map;
+
+    public:
+
+        /**
+         * Construct index.
+         *
+         * @param builder The layer we are building containing the key table
+         *        we are creating the index for.
+         * @param pool The string pool shared with the other layers.
+         */
+        pooled_key_index(layer_builder& builder, string_pool& pool) :
+            m_builder(builder),
+            m_pool(pool) {
+        }
+
+        /**
+         * Get the index value for the specified key. If the key was not in
+         * the table, it will be added.
+         *
+         * @param key The key to store.
+         * @returns The index value of they key.
+         */
+        index_value operator()(const data_view key) {
+            const auto pool_id = m_pool.id(key).value();
+            if (pool_id >= m_map.size()) {
+                m_map.resize(pool_id + 1);
+            }
+            auto& idx = m_map[pool_id];
+            if (!idx.valid()) {
+                idx = m_builder.add_key_without_dup_check(key);
+            }
+            return idx;
+        }
+
+    }; // class pooled_key_index
+
+    /**
+     * Used to store the mapping between property values and the index
+     * value in the table stored in a layer, like value_index_internal,
+     * but backed by a string_pool shared between layers. The pool stores
+     * the encoded form of the values, so one pool can be shared between
+     * values of different types (and with a pooled_key_index).
+     */
+    class pooled_value_index {
+
+        layer_builder& m_builder;
+
+        string_pool& m_pool;
+
+        // Maps pool ids to the value table index of this layer.
+        std::vector<index_value> m_map;
+
+        index_value& entry_for(const data_view encoded_value) {
+            const auto pool_id = m_pool.id(encoded_value).value();
+            if (pool_id >= m_map.size()) {
+                m_map.resize(pool_id + 1);
+            }
+            return m_map[pool_id];
+        }
+
+    public:
+
+        /**
+         * Construct index.
+         *
+         * @param builder The layer we are building containing the value
+         *        table we are creating the index for.
+         * @param pool The string pool shared with the other layers.
+         */
+        pooled_value_index(layer_builder& builder, string_pool& pool) :
+            m_builder(builder),
+            m_pool(pool) {
+        }
+
+        /**
+         * Get the index value for the specified value. If the value was not
+         * in the table, it will be added.
+         *
+         * @param value The value to store.
+         * @returns The index value of they value.
+         */
+        index_value operator()(const encoded_property_value& value) {
+            auto& idx = entry_for(value.data());
+            if (!idx.valid()) {
+                idx = m_builder.add_value_without_dup_check(value);
+            }
+            return idx;
+        }
+
+        /**
+         * Get the index value for the specified value. If the value was not
+         * in the table, it will be added.
+         *
+         * @param value The value to store.
+         * @returns The index value of they value.
+         */
+        index_value operator()(const property_value value) {
+            auto& idx = entry_for(value.data());
+            if (!idx.valid()) {
+                idx = m_builder.add_value_without_dup_check(value);
+            }
+            return idx;
+        }
+
+    }; // class pooled_value_index
+
 } // namespace vtzero
 
 #endif // VTZERO_INDEX_HPP
@@ -20,16 +20,252 @@ documentation.
 #include "feature.hpp"
 #include "geometry.hpp"
 #include "property_value.hpp"
+#include "runtime_stats.hpp"
 #include "types.hpp"
 
 #include <protozero/pbf_message.hpp>
+#include <protozero/varint.hpp>
 
+#include <atomic>
 #include <cstdint>
+#include <cstring>
 #include <iterator>
+#include <mutex>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace vtzero {
 
+    namespace detail {
+
+        /**
+         * An atomic bool that can be copied. The copy gets the value of
+         * the original, but is its own atomic.
+         */
+        class copyable_atomic_bool {
+
+            std::atomic<bool> m_value{false};
+
+        public:
+
+            copyable_atomic_bool() noexcept = default;
+
+            ~copyable_atomic_bool() noexcept = default;
+
+            /// Copy constructor
+            copyable_atomic_bool(const copyable_atomic_bool& other) noexcept :
+                m_value(other.load()) {
+            }
+
+            /// Copy assignment
+            copyable_atomic_bool& operator=(const copyable_atomic_bool& other) noexcept {
+                store(other.load());
+                return *this;
+            }
+
+            /// Get the value with acquire semantics.
+            bool load() const noexcept {
+                return m_value.load(std::memory_order_acquire);
+            }
+
+            /// Set the value with release semantics.
+            void store(bool value) noexcept {
+                m_value.store(value, std::memory_order_release);
+            }
+
+        }; // class copyable_atomic_bool
+
+        /**
+         * A mutex that can be copied. The copy is a new, unlocked mutex,
+         * because the only state a mutex has is whether it is locked and
+         * that can not be meaningfully copied.
+         */
+        class copyable_mutex {
+
+            std::mutex m_mutex;
+
+        public:
+
+            copyable_mutex() = default;
+
+            ~copyable_mutex() = default;
+
+            /// Copy constructor
+            copyable_mutex(const copyable_mutex& /*other*/) noexcept {
+            }
+
+            /// Copy assignment
+            copyable_mutex& operator=(const copyable_mutex& /*other*/) noexcept {
+                return *this;
+            }
+
+            /// Lock the mutex.
+            void lock() {
+                m_mutex.lock();
+            }
+
+            /// Unlock the mutex.
+            void unlock() {
+                m_mutex.unlock();
+            }
+
+        }; // class copyable_mutex
+
+    } // namespace detail
+
+    class feature_range;
+
+    /**
+     * A property value from the layer value table decoded into a compact
+     * tagged-union representation: the type tag plus the scalar value or
+     * the view of the string data. Unlike with property_value, accessing
+     * the type or the value is a plain member load, the pbf encoding is
+     * not parsed again on every access.
+     *
+     * Objects of this class are created by layer::build_value_cache() and
+     * accessed with layer::decoded_value().
+     */
+    class decoded_property_value {
+
+        data_view m_string_value{};
+
+        union {
+            float m_float_value;
+            double m_double_value;
+            int64_t m_int_value;
+            uint64_t m_uint_value;
+            bool m_bool_value;
+        };
+
+        property_value_type m_type;
+
+        void check_type(const property_value_type type) const {
+            if (m_type != type) {
+                throw type_exception{};
+            }
+        }
+
+    public:
+
+        /**
+         * Construct by decoding the specified property value.
+         *
+         * @throws format_exception if the encoding is invalid.
+         * @pre @code value.valid() @endcode
+         */
+        explicit decoded_property_value(const property_value value) :
+            m_uint_value(0),
+            m_type(value.type()) {
+            switch (m_type) {
+                case property_value_type::string_value:
+                    m_string_value = value.string_value();
+                    break;
+                case property_value_type::float_value:
+                    m_float_value = value.float_value();
+                    break;
+                case property_value_type::double_value:
+                    m_double_value = value.double_value();
+                    break;
+                case property_value_type::int_value:
+                    m_int_value = value.int_value();
+                    break;
+                case property_value_type::uint_value:
+                    m_uint_value = value.uint_value();
+                    break;
+                case property_value_type::sint_value:
+                    m_int_value = value.sint_value();
+                    break;
+                default: // case property_value_type::bool_value:
+                    m_bool_value = value.bool_value();
+                    break;
+            }
+        }
+
+        /// Get the type of this value.
+        property_value_type type() const noexcept {
+            return m_type;
+        }
+
+        /**
+         * Get string value of this object.
+         *
+         * @throws type_exception if the type of this property value is
+         *                        something other than string.
+         */
+        data_view string_value() const {
+            check_type(property_value_type::string_value);
+            return m_string_value;
+        }
+
+        /**
+         * Get float value of this object.
+         *
+         * @throws type_exception if the type of this property value is
+         *                        something other than float.
+         */
+        float float_value() const {
+            check_type(property_value_type::float_value);
+            return m_float_value;
+        }
+
+        /**
+         * Get double value of this object.
+         *
+         * @throws type_exception if the type of this property value is
+         *                        something other than double.
+         */
+        double double_value() const {
+            check_type(property_value_type::double_value);
+            return m_double_value;
+        }
+
+        /**
+         * Get int value of this object.
+         *
+         * @throws type_exception if the type of this property value is
+         *                        something other than int.
+         */
+        std::int64_t int_value() const {
+            check_type(property_value_type::int_value);
+            return m_int_value;
+        }
+
+        /**
+         * Get uint value of this object.
+         *
+         * @throws type_exception if the type of this property value is
+         *                        something other than uint.
+         */
+        std::uint64_t uint_value() const {
+            check_type(property_value_type::uint_value);
+            return m_uint_value;
+        }
+
+        /**
+         * Get sint value of this object.
+         *
+         * @throws type_exception if the type of this property value is
+         *                        something other than sint.
+         */
+        std::int64_t sint_value() const {
+            check_type(property_value_type::sint_value);
+            return m_int_value;
+        }
+
+        /**
+         * Get bool value of this object.
+         *
+         * @throws type_exception if the type of this property value is
+         *                        something other than bool.
+         */
+        bool bool_value() const {
+            check_type(property_value_type::bool_value);
+            return m_bool_value;
+        }
+
+    }; // class decoded_property_value
+
     /**
      * A layer according to spec 4.1. It contains a version, the extent,
      * and a name. For the most efficient way to access the features in this
@@ -50,11 +286,16 @@ namespace vtzero {
      * @endcode
      *
      * Note that the layer class uses mutable members inside to cache the
-     * key and value tables. It can not be used safely in several threads
-     * at once!
+     * key and value tables and the optional feature index. The lazy
+     * initialization of the key and value tables is thread-safe, so a
+     * layer can be shared read-only between threads. Building the feature
+     * index and the spatial index is not, call build_feature_index() and/or
+     * build_spatial_index() before sharing the layer if you need them.
      */
     class layer {
 
+        friend class tile_index;
+
         data_view m_data{};
         uint32_t m_version = 1; // defaults to 1, see https://github.com/mapbox/vector-tile-spec/blob/master/2.1/vector_tile.proto#L55
         uint32_t m_extent = 4096; // defaults to 4096, see https://github.com/mapbox/vector-tile-spec/blob/master/2.1/vector_tile.proto#L70
@@ -65,13 +306,27 @@ namespace vtzero {
         mutable std::vector<property_value> m_value_table;
         mutable std::size_t m_key_table_size = 0;
         mutable std::size_t m_value_table_size = 0;
+        mutable std::vector<data_view> m_feature_index;
+        mutable std::unordered_map<uint64_t, data_view> m_features_by_id;
+        mutable std::unordered_map<std::string, index_value> m_key_index;
+        mutable std::vector<std::vector<data_view>> m_spatial_index;
+        mutable std::vector<decoded_property_value> m_decoded_value_table;
+        mutable uint32_t m_spatial_index_size = 0; // cells per side
+        mutable bool m_has_feature_index = false;
+        mutable bool m_has_value_cache = false;
+        mutable detail::copyable_mutex m_tables_mutex;
+        mutable detail::copyable_atomic_bool m_tables_initialized;
+        mutable detail::copyable_atomic_bool m_key_index_initialized;
 
         void initialize_tables() const {
-            m_key_table.reserve(m_key_table_size);
-            m_key_table_size = 0;
+            const std::lock_guard<detail::copyable_mutex> lock{m_tables_mutex};
+
+            if (m_tables_initialized.load()) {
+                return;
+            }
 
+            m_key_table.reserve(m_key_table_size);
             m_value_table.reserve(m_value_table_size);
-            m_value_table_size = 0;
 
             protozero::pbf_message<detail::pbf_layer> reader{m_data};
             while (reader.next()) {
@@ -86,6 +341,40 @@ namespace vtzero {
                         reader.skip(); // ignore unknown fields
                 }
             }
+
+            VTZERO_STATS_COUNT(table_builds);
+            m_tables_initialized.store(true);
+        }
+
+        void initialize_key_index() const {
+            // Make sure the key table is built before taking the lock,
+            // key_table() uses the same mutex internally.
+            const auto& table = key_table();
+
+            const std::lock_guard<detail::copyable_mutex> lock{m_tables_mutex};
+
+            if (m_key_index_initialized.load()) {
+                return;
+            }
+
+            m_key_index.reserve(table.size());
+            uint32_t n = 0;
+            for (const auto& key : table) {
+                m_key_index.emplace(std::string(key), index_value{n});
+                ++n;
+            }
+
+            m_key_index_initialized.store(true);
+        }
+
+        uint32_t spatial_index_cell(const int32_t coord) const noexcept {
+            int64_t c = coord;
+            if (c < 0) {
+                c = 0;
+            } else if (c >= m_extent) {
+                c = m_extent - 1;
+            }
+            return static_cast<uint32_t>(c * m_spatial_index_size / m_extent);
         }
 
     public:
@@ -228,14 +517,15 @@ namespace vtzero {
          * Return a reference to the key table.
          *
          * Complexity: Amortized constant. First time the table is needed
-         *             it needs to be created.
+         *             it needs to be created. This is safe even if several
+         *             threads need the table at the same time.
          *
          * @pre @code valid() @endcode
          */
         const std::vector<data_view>& key_table() const {
             vtzero_assert(valid());
 
-            if (m_key_table_size > 0) {
+            if (!m_tables_initialized.load()) {
                 initialize_tables();
             }
             return m_key_table;
@@ -245,14 +535,15 @@ namespace vtzero {
          * Return a reference to the value table.
          *
          * Complexity: Amortized constant. First time the table is needed
-         *             it needs to be created.
+         *             it needs to be created. This is safe even if several
+         *             threads need the table at the same time.
          *
          * @pre @code valid() @endcode
          */
         const std::vector<property_value>& value_table() const {
             vtzero_assert(valid());
 
-            if (m_value_table_size > 0) {
+            if (!m_tables_initialized.load()) {
                 initialize_tables();
             }
             return m_value_table;
@@ -267,7 +558,7 @@ namespace vtzero {
          * @returns Size of the key table.
          */
         std::size_t key_table_size() const noexcept {
-            return m_key_table_size > 0 ? m_key_table_size : m_key_table.size();
+            return m_key_table_size;
         }
 
         /**
@@ -279,7 +570,7 @@ namespace vtzero {
          * @returns Size of the value table.
          */
         std::size_t value_table_size() const noexcept {
-            return m_value_table_size > 0 ? m_value_table_size : m_value_table.size();
+            return m_value_table_size;
         }
 
         /**
@@ -322,6 +613,91 @@ namespace vtzero {
             return table[index.value()];
         }
 
+        /**
+         * Build the decoded-value cache: every entry of the value table is
+         * decoded once into the compact decoded_property_value
+         * representation. Afterwards decoded_value() gives access to the
+         * values without parsing their pbf encoding again. This pays off
+         * when the same table entries are accessed once per referencing
+         * feature, for instance when evaluating typed comparisons in a
+         * filter over all features.
+         *
+         * Calling this a second time does nothing. Building the cache is
+         * not thread-safe, build it before sharing the layer between
+         * threads if you need it.
+         *
+         * Complexity: Linear in the size of the value table.
+         *
+         * @throws format_exception if a table entry has an invalid
+         *         encoding.
+         * @pre @code valid() @endcode
+         */
+        void build_value_cache() const {
+            vtzero_assert(valid());
+
+            if (m_has_value_cache) {
+                return;
+            }
+
+            const auto& table = value_table();
+            m_decoded_value_table.reserve(table.size());
+            for (const auto value : table) {
+                m_decoded_value_table.emplace_back(value);
+            }
+
+            m_has_value_cache = true;
+        }
+
+        /**
+         * Was the decoded-value cache built for this layer?
+         *
+         * Complexity: Constant.
+         */
+        bool has_value_cache() const noexcept {
+            return m_has_value_cache;
+        }
+
+        /**
+         * Get the decoded property value with the given index.
+         *
+         * Complexity: Constant.
+         *
+         * @throws out_of_range_exception if the index is out of range.
+         * @pre @code has_value_cache() @endcode
+         */
+        const decoded_property_value& decoded_value(index_value index) const {
+            vtzero_assert(has_value_cache());
+
+            if (index.value() >= m_decoded_value_table.size()) {
+                throw out_of_range_exception{index.value()};
+            }
+
+            return m_decoded_value_table[index.value()];
+        }
+
+        /**
+         * Get the index of the specified property key in the key table.
+         *
+         * Complexity: Amortized constant. First time it is needed a hash
+         *             index over the key table is built. This is safe even
+         *             if several threads need the index at the same time.
+         *
+         * @param key The property key to look for.
+         * @returns Index of the key or the invalid index_value if the key
+         *          is not in the key table.
+         * @pre @code valid() @endcode
+         */
+        index_value key_index(const data_view key) const {
+            vtzero_assert(valid());
+
+            if (!m_key_index_initialized.load()) {
+                initialize_key_index();
+            }
+
+            const auto it = m_key_index.find(std::string(key));
+            return it != m_key_index.end() ? it->second : index_value{};
+        }
+
         /**
          * Get the next feature in this layer.
          *
@@ -360,6 +736,26 @@ namespace vtzero {
             m_layer_reader = protozero::pbf_message<detail::pbf_layer>{m_data};
         }
 
+        /**
+         * Get a forward-iterable range over the features of this layer.
+         * Unlike next_feature() this has no cursor state in the layer
+         * object: every call to begin() starts from the first feature
+         * and independent iterators can be in flight at the same time,
+         * so the range can be fed into standard algorithms.
+         *
+         * @code
+         *   for (const auto& feature : layer.features()) {
+         *     ...
+         *   }
+         * @endcode
+         *
+         * The layer must stay valid as long as the range or any of its
+         * iterators are used.
+         *
+         * @pre @code valid() @endcode
+         */
+        feature_range features() const noexcept;
+
         /**
          * Call a function for each feature in this layer.
          *
@@ -385,6 +781,298 @@ namespace vtzero {
             return true;
         }
 
+        /**
+         * Call a function with the value index of every property with the
+         * specified key in any feature of this layer.
+         *
+         * The key is resolved to its key table index once. After that one
+         * tight scan over the packed tags arrays of all features compares
+         * integers only, no feature or property objects are created and
+         * no values are looked at for non-matching pairs. Use this to
+         * extract a single attribute column from a layer.
+         *
+         * The function is called in the order the features appear in the
+         * layer. A feature with several properties with the key gets
+         * several calls, a feature without the key gets none.
+         *
+         * @tparam TFunc The type of the function. It must take a single
+         *         argument of type index_value.
+         * @param key The property key to look for.
+         * @param func The function to call for each match.
+         * @returns The number of matching properties found.
+         * @throws format_exception if the layer data is ill-formed.
+         * @throws any protozero exception if the protobuf encoding is
+         *         invalid.
+         * @pre @code valid() @endcode
+         */
+        template <typename TFunc>
+        std::size_t project_property_indexes(const data_view key, TFunc&& func) const {
+            vtzero_assert(valid());
+
+            const auto wanted_index = key_index(key);
+            if (!wanted_index.valid()) {
+                return 0;
+            }
+            const uint32_t wanted = wanted_index.value();
+
+            std::size_t count = 0;
+            protozero::pbf_message<detail::pbf_layer> layer_reader{m_data};
+            while (layer_reader.next(detail::pbf_layer::features,
+                                     protozero::pbf_wire_type::length_delimited)) {
+                protozero::pbf_message<detail::pbf_feature> feature_reader{layer_reader.get_view()};
+                while (feature_reader.next(detail::pbf_feature::tags,
+                                           protozero::pbf_wire_type::length_delimited)) {
+                    const auto tags = feature_reader.get_view();
+                    const char* data = tags.data();
+                    const char* const end = data + tags.size();
+                    bool is_key = true;
+                    uint32_t current_key = 0;
+                    // Tight varint loop with a fast path for single-byte
+                    // varints like in feature::decode_property_indexes().
+                    while (data != end) {
+                        auto value = static_cast<uint32_t>(static_cast<uint8_t>(*data));
+                        if (value < 0x80U) {
+                            ++data;
+                        } else {
+                            value = static_cast<uint32_t>(protozero::decode_varint(&data, end));
+                        }
+                        if (is_key) {
+                            current_key = value;
+                        } else if (current_key == wanted) {
+                            func(index_value{value});
+                            ++count;
+                        }
+                        is_key = !is_key;
+                    }
+                    if (!is_key) {
+                        throw format_exception{"unpaired property key/value indexes (spec 4.4)"};
+                    }
+                }
+            }
+
+            return count;
+        }
+
+        /**
+         * Call a function with the value of every property with the
+         * specified key in any feature of this layer. Like
+         * project_property_indexes(), but the matching value indexes are
+         * resolved through the value table, so the function gets the
+         * property_values directly.
+         *
+         * @tparam TFunc The type of the function. It must take a single
+         *         argument of type property_value.
+         * @param key The property key to look for.
+         * @param func The function to call for each match.
+         * @returns The number of matching properties found.
+         * @throws format_exception if the layer data is ill-formed.
+         * @throws out_of_range_exception if a matching value index is out
+         *         of range.
+         * @throws any protozero exception if the protobuf encoding is
+         *         invalid.
+         * @pre @code valid() @endcode
+         */
+        template <typename TFunc>
+        std::size_t project_property(const data_view key, TFunc&& func) const {
+            vtzero_assert(valid());
+
+            const auto& table = value_table();
+            return project_property_indexes(key, [&table, &func](const index_value index) {
+                if (index.value() >= table.size()) {
+                    throw out_of_range_exception{index.value()};
+                }
+                func(table[index.value()]);
+            });
+        }
+
+        /**
+         * Build an index into the features of this layer. This needs one
+         * scan over the layer data. Afterwards get_feature() works in
+         * constant time and get_feature_by_id() in amortized constant time
+         * instead of linear time.
+         *
+         * Calling this a second time does nothing.
+         *
+         * Complexity: Linear in the number of features.
+         *
+         * @throws any protozero exception if the protobuf encoding is invalid.
+         * @pre @code valid() @endcode
+         */
+        void build_feature_index() const {
+            vtzero_assert(valid());
+
+            if (m_has_feature_index) {
+                return;
+            }
+
+            m_feature_index.reserve(m_num_features);
+            protozero::pbf_message<detail::pbf_layer> layer_reader{m_data};
+            while (layer_reader.next(detail::pbf_layer::features, protozero::pbf_wire_type::length_delimited)) {
+                const auto feature_data = layer_reader.get_view();
+                m_feature_index.push_back(feature_data);
+                protozero::pbf_message<detail::pbf_feature> feature_reader{feature_data};
+                if (feature_reader.next(detail::pbf_feature::id, protozero::pbf_wire_type::varint)) {
+                    m_features_by_id.emplace(feature_reader.get_uint64(), feature_data);
+                }
+            }
+
+            m_has_feature_index = true;
+        }
+
+        /**
+         * Was the feature index built for this layer?
+         *
+         * Complexity: Constant.
+         */
+        bool has_feature_index() const noexcept {
+            return m_has_feature_index;
+        }
+
+        /**
+         * Build a spatial index over the features of this layer. The tile
+         * extent is divided into a grid of 2^cell_bits x 2^cell_bits cells
+         * and each feature is binned into all cells its bounding box
+         * overlaps. The bounding boxes are computed with the fast
+         * decode_bounding_box() pass, no geometry is fully decoded.
+         *
+         * Afterwards for_each_feature_near() only looks at the features in
+         * one grid cell instead of all features of the layer. This is
+         * useful for hit-testing on dense layers.
+         *
+         * Calling this a second time does nothing, even if cell_bits is
+         * different.
+         *
+         * Complexity: Linear in the number of features.
+         *
+         * @param cell_bits Number of bits used for the cell coordinates in
+         *        each dimension, ie the grid has 2^cell_bits cells per
+         *        side. Must be between 1 and 15.
+         * @throws geometry_exception if a geometry in the layer is
+         *         ill-formed.
+         * @throws any protozero exception if the protobuf encoding is
+         *         invalid.
+         * @pre @code valid() @endcode
+         */
+        void build_spatial_index(const uint32_t cell_bits = 3) const {
+            vtzero_assert(valid());
+            vtzero_assert(cell_bits >= 1 && cell_bits <= 15);
+
+            if (m_spatial_index_size != 0) {
+                return;
+            }
+
+            const uint32_t size = 1U << cell_bits;
+            m_spatial_index.assign(static_cast<std::size_t>(size) * size, {});
+            m_spatial_index_size = size;
+
+            protozero::pbf_message<detail::pbf_layer> layer_reader{m_data};
+            while (layer_reader.next(detail::pbf_layer::features, protozero::pbf_wire_type::length_delimited)) {
+                const auto feature_data = layer_reader.get_view();
+
+                data_view geometry_data{};
+                protozero::pbf_message<detail::pbf_feature> feature_reader{feature_data};
+                if (feature_reader.next(detail::pbf_feature::geometry, protozero::pbf_wire_type::length_delimited)) {
+                    geometry_data = feature_reader.get_view();
+                }
+
+                const auto bbox = decode_bounding_box(geometry{geometry_data, GeomType::UNKNOWN});
+                if (!bbox.valid()) {
+                    continue;
+                }
+
+                const auto min_x = spatial_index_cell(bbox.min.x);
+                const auto max_x = spatial_index_cell(bbox.max.x);
+                const auto max_y = spatial_index_cell(bbox.max.y);
+                for (auto cy = spatial_index_cell(bbox.min.y); cy <= max_y; ++cy) {
+                    for (auto cx = min_x; cx <= max_x; ++cx) {
+                        m_spatial_index[static_cast<std::size_t>(cy) * size + cx].push_back(feature_data);
+                    }
+                }
+            }
+        }
+
+        /**
+         * Was the spatial index built for this layer?
+         *
+         * Complexity: Constant.
+         */
+        bool has_spatial_index() const noexcept {
+            return m_spatial_index_size != 0;
+        }
+
+        /**
+         * Call a function for each feature whose bounding box overlaps the
+         * spatial index cell containing the specified point. This is a
+         * superset of the features containing the point; do precise
+         * geometry tests on the features you get.
+         *
+         * Coordinates outside the tile extent are clamped to the border
+         * cells.
+         *
+         * Complexity: Linear in the number of features in the cell.
+         *
+         * @tparam TFunc The type of the function. It must take a single
+         *         argument of type feature&& and return a bool. If the
+         *         function returns false, the iteration will be stopped.
+         * @param p Point in extent coordinates.
+         * @param func The function to call.
+         * @returns true if the iteration was completed and false otherwise.
+         * @pre @code valid() && has_spatial_index() @endcode
+         */
+        template <typename TFunc>
+        bool for_each_feature_near(const point p, TFunc&& func) const {
+            vtzero_assert(valid());
+            vtzero_assert(has_spatial_index());
+
+            const auto cell = static_cast<std::size_t>(spatial_index_cell(p.y)) * m_spatial_index_size + spatial_index_cell(p.x);
+            for (const auto feature_data : m_spatial_index[cell]) {
+                if (!std::forward<TFunc>(func)(feature{this, feature_data})) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        /**
+         * Get the nth feature in this layer.
+         *
+         * Note that the feature returned will internally contain a pointer to
+         * the layer it came from. The layer has to stay valid as long as the
+         * feature is used.
+         *
+         * Complexity: Constant if build_feature_index() was called before,
+         *             linear in the number of features otherwise.
+         *
+         * @param n The index of the feature.
+         * @returns Feature with the specified index or the invalid feature
+         *          if the index is larger than the number of features.
+         * @throws format_exception if the layer data is ill-formed.
+         * @throws any protozero exception if the protobuf encoding is invalid.
+         * @pre @code valid() @endcode
+         */
+        feature get_feature(std::size_t n) const {
+            vtzero_assert(valid());
+
+            if (m_has_feature_index) {
+                if (n >= m_feature_index.size()) {
+                    return feature{};
+                }
+                return feature{this, m_feature_index[n]};
+            }
+
+            protozero::pbf_message<detail::pbf_layer> layer_reader{m_data};
+            while (layer_reader.next(detail::pbf_layer::features, protozero::pbf_wire_type::length_delimited)) {
+                if (n == 0) {
+                    return feature{this, layer_reader.get_view()};
+                }
+                layer_reader.skip();
+                --n;
+            }
+
+            return feature{};
+        }
+
         /**
          * Get the feature with the specified ID. If there are several features
          * with the same ID, it is undefined which one you'll get.
@@ -393,7 +1081,8 @@ namespace vtzero {
          * the layer it came from. The layer has to stay valid as long as the
          * feature is used.
          *
-         * Complexity: Linear in the number of features.
+         * Complexity: Amortized constant if build_feature_index() was called
+         *             before, linear in the number of features otherwise.
          *
          * @param id The ID to look for.
          * @returns Feature with the specified ID or the invalid feature if
@@ -405,6 +1094,11 @@ namespace vtzero {
         feature get_feature_by_id(uint64_t id) const {
             vtzero_assert(valid());
 
+            if (m_has_feature_index) {
+                const auto it = m_features_by_id.find(id);
+                return it != m_features_by_id.end() ? feature{this, it->second} : feature{};
+            }
+
             protozero::pbf_message<detail::pbf_layer> layer_reader{m_data};
             while (layer_reader.next(detail::pbf_layer::features, protozero::pbf_wire_type::length_delimited)) {
                 const auto feature_data = layer_reader.get_view();
@@ -421,6 +1115,127 @@ namespace vtzero {
 
     }; // class layer
 
+    /**
+     * Forward iterator over the features of a layer. Usually not created
+     * directly, use layer::features().
+     *
+     * The iterator owns its position in the layer data and a copy of the
+     * current feature, so copies of an iterator can be advanced
+     * independently and nothing is allocated.
+     */
+    class feature_iterator {
+
+        protozero::pbf_message<detail::pbf_layer> m_reader{};
+        const layer* m_layer = nullptr;
+        feature m_feature{};
+
+        void advance() {
+            if (m_reader.next(detail::pbf_layer::features,
+                              protozero::pbf_wire_type::length_delimited)) {
+                m_feature = feature{m_layer, m_reader.get_view()};
+            } else {
+                m_feature = feature{};
+            }
+        }
+
+    public:
+
+        /// @name Iterator traits
+        ///@{
+        using iterator_category = std::forward_iterator_tag; ///< iterator category
+        using value_type        = feature;                   ///< value type
+        using difference_type   = std::ptrdiff_t;            ///< difference type
+        using pointer           = const feature*;            ///< pointer type
+        using reference         = const feature&;            ///< reference type
+        ///@}
+
+        /// Construct the past-the-end iterator.
+        feature_iterator() = default;
+
+        /**
+         * Construct an iterator pointing to the first feature in the
+         * specified layer.
+         *
+         * @throws format_exception if the layer data is ill-formed.
+         * @throws any protozero exception if the protobuf encoding is
+         *         invalid.
+         */
+        explicit feature_iterator(const layer* layer) :
+            m_reader(layer->data()),
+            m_layer(layer) {
+            advance();
+        }
+
+        /// Get the current feature.
+        reference operator*() const noexcept {
+            return m_feature;
+        }
+
+        /// Access the current feature.
+        pointer operator->() const noexcept {
+            return &m_feature;
+        }
+
+        /// Advance to the next feature.
+        feature_iterator& operator++() {
+            advance();
+            return *this;
+        }
+
+        /// Advance to the next feature (postfix).
+        feature_iterator operator++(int) {
+            const feature_iterator tmp{*this};
+            ++(*this);
+            return tmp;
+        }
+
+        /// Iterators are equal if they point to the same feature or are
+        /// both at the end.
+        friend bool operator==(const feature_iterator& lhs, const feature_iterator& rhs) noexcept {
+            return lhs.m_feature.data().data() == rhs.m_feature.data().data();
+        }
+
+        /// Iterators are not equal if operator==() returns false.
+        friend bool operator!=(const feature_iterator& lhs, const feature_iterator& rhs) noexcept {
+            return !(lhs == rhs);
+        }
+
+    }; // class feature_iterator
+
+    /**
+     * A forward-iterable range over the features of a layer as returned
+     * by layer::features(). The layer must stay valid as long as the
+     * range or any of its iterators are used.
+     */
+    class feature_range {
+
+        const layer* m_layer = nullptr;
+
+    public:
+
+        /// Construct a range over the features of the specified layer.
+        explicit feature_range(const layer* layer) noexcept :
+            m_layer(layer) {
+        }
+
+        /// Iterator to the first feature.
+        feature_iterator begin() const {
+            return feature_iterator{m_layer};
+        }
+
+        /// Past-the-end iterator.
+        feature_iterator end() const noexcept {
+            return {};
+        }
+
+    }; // class feature_range
+
+    inline feature_range layer::features() const noexcept {
+        vtzero_assert_in_noexcept_function(valid());
+
+        return feature_range{this};
+    }
+
     inline property feature::next_property() {
         const auto idxs = next_property_indexes();
         property p{};
@@ -459,6 +1274,39 @@ namespace vtzero {
         return {ki, vi};
     }
 
+    inline property feature::get_property_by_key(const data_view key) const {
+        vtzero_assert(valid());
+
+        const auto wanted = m_layer->key_index(key);
+        if (!wanted.valid()) {
+            return {};
+        }
+
+        for (auto it = m_properties.begin(); it != m_properties.end();) {
+            const uint32_t ki = *it++;
+
+            assert(it != m_properties.end());
+            const uint32_t vi = *it++;
+
+            if (ki == wanted.value()) {
+                if (!index_value{vi}.valid()) {
+                    throw out_of_range_exception{vi};
+                }
+                return {m_layer->key(wanted), m_layer->value(vi)};
+            }
+        }
+
+        return {};
+    }
+
+    inline property feature::get_property_by_key(const std::string& key) const {
+        return get_property_by_key(data_view{key.data(), key.size()});
+    }
+
+    inline property feature::get_property_by_key(const char* key) const {
+        return get_property_by_key(data_view{key, std::strlen(key)});
+    }
+
     template <typename TFunc>
     bool feature::for_each_property(TFunc&& func) const {
         vtzero_assert(valid());
@@ -483,6 +1331,32 @@ namespace vtzero {
         return true;
     }
 
+    template <typename TFunc>
+    bool feature::for_each_property(TFunc&& func, std::vector<uint32_t>& scratch) const {
+        vtzero_assert(valid());
+
+        decode_property_indexes(scratch);
+
+        for (auto it = scratch.cbegin(); it != scratch.cend();) {
+            const uint32_t ki = *it++;
+            if (!index_value{ki}.valid()) {
+                throw out_of_range_exception{ki};
+            }
+
+            assert(it != scratch.cend());
+            const uint32_t vi = *it++;
+            if (!index_value{vi}.valid()) {
+                throw out_of_range_exception{vi};
+            }
+
+            if (!std::forward<TFunc>(func)(property{m_layer->key(ki), m_layer->value(vi)})) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
     template <typename TFunc>
     bool feature::for_each_property_indexes(TFunc&& func) const {
         vtzero_assert(valid());
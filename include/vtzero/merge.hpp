@@ -0,0 +1,191 @@
+#ifndef VTZERO_MERGE_HPP
+#define VTZERO_MERGE_HPP
+
+/*****************************************************************************
+
+vtzero - Tiny and fast vector tile decoder and encoder in C++.
+
+This file is from https://github.com/mapbox/vtzero where you can find more
+documentation.
+
+*****************************************************************************/
+
+/**
+ * @file merge.hpp
+ *
+ * @brief Contains the tile_merger class.
+ */
+
+#include "builder.hpp"
+#include "feature.hpp"
+#include "layer.hpp"
+#include "types.hpp"
+#include "vector_tile.hpp"
+
+#include <protozero/pbf_builder.hpp>
+
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace vtzero {
+
+    /**
+     * Merges the layers of several tiles into one tile. Layers with the
+     * same name are combined into a single output layer: the key/value
+     * tables are unified through a shared interner, so entries used by
+     * several input layers are stored only once, and the features' IDs and
+     * geometries are spliced into the output as raw bytes with only their
+     * packed tags rewritten. Nothing is decoded or re-encoded point by
+     * point, which makes this much cheaper than rebuilding everything
+     * through the feature builders.
+     *
+     * @code
+     * vtzero::tile_builder tbuilder;
+     * vtzero::tile_merger merger{tbuilder};
+     * merger.add_tile(base_tile_data);
+     * merger.add_tile(traffic_tile_data);
+     * const std::string data = tbuilder.serialize();
+     * @endcode
+     *
+     * Layers appear in the output in the order they were first seen. When
+     * layers with the same name disagree about version or extent, the
+     * values of the first one win. Feature IDs are copied as-is, keeping
+     * them unique across the input tiles is the caller's concern. Input
+     * layers without features are skipped.
+     */
+    class tile_merger {
+
+        struct merged_layer {
+
+            vtzero::layer_builder layer_builder;
+            std::unordered_map<std::string, index_value> keys{};
+            std::unordered_map<std::string, index_value> values{};
+
+            merged_layer(vtzero::tile_builder& tile, const layer& layer) :
+                layer_builder(tile, layer) {
+            }
+
+        }; // struct merged_layer
+
+        vtzero::tile_builder* m_tile_builder;
+        std::unordered_map<std::string, merged_layer> m_layers;
+
+        index_value map_key(merged_layer& merged, const data_view key) {
+            std::string k{key};
+            auto it = merged.keys.find(k);
+            if (it == merged.keys.end()) {
+                it = merged.keys.emplace(std::move(k), merged.layer_builder.add_key_without_dup_check(key)).first;
+            }
+            return it->second;
+        }
+
+        index_value map_value(merged_layer& merged, const property_value value) {
+            std::string v{value.data()};
+            auto it = merged.values.find(v);
+            if (it == merged.values.end()) {
+                it = merged.values.emplace(std::move(v), merged.layer_builder.add_value_without_dup_check(value)).first;
+            }
+            return it->second;
+        }
+
+        void merge_into(merged_layer& merged, const layer& layer) {
+            // per-input-layer translation arrays so each table entry is
+            // interned at most once
+            std::vector<index_value> key_map(layer.key_table_size());
+            std::vector<index_value> value_map(layer.value_table_size());
+
+            auto& layer_impl = merged.layer_builder.get_layer_impl();
+            layer.for_each_feature([&](const feature& feature) {
+                protozero::pbf_builder<detail::pbf_feature> feature_writer{layer_impl.message(), detail::pbf_layer::features};
+
+                if (feature.has_id()) {
+                    feature_writer.add_uint64(detail::pbf_feature::id, feature.id());
+                }
+
+                feature_writer.add_enum(detail::pbf_feature::type, static_cast<int32_t>(feature.geometry_type()));
+                feature_writer.add_string(detail::pbf_feature::geometry, feature.geometry().data());
+
+                if (!feature.empty()) {
+                    protozero::packed_field_uint32 pbf_tags{feature_writer, detail::pbf_feature::tags};
+                    feature.for_each_property_indexes([&](const index_value_pair idxs) {
+                        auto& k = key_map[idxs.key().value()];
+                        if (!k.valid()) {
+                            k = map_key(merged, layer.key(idxs.key()));
+                        }
+
+                        auto& v = value_map[idxs.value().value()];
+                        if (!v.valid()) {
+                            v = map_value(merged, layer.value(idxs.value()));
+                        }
+
+                        pbf_tags.add_element(k.value());
+                        pbf_tags.add_element(v.value());
+                        return true;
+                    });
+                }
+
+                layer_impl.increment_feature_count();
+                return true;
+            });
+        }
+
+    public:
+
+        /**
+         * Construct a tile_merger writing into the specified tile builder.
+         *
+         * @param tile The tile builder the merged layers are created in.
+         *        Must stay valid as long as the tile_merger is used.
+         */
+        explicit tile_merger(vtzero::tile_builder& tile) noexcept :
+            m_tile_builder(&tile) {
+        }
+
+        /**
+         * Merge a single layer into the output tile. If a layer with the
+         * same name was added before, the features are appended to that
+         * layer, otherwise a new layer is created.
+         *
+         * @param layer The layer to merge. Layers without features are
+         *        skipped.
+         * @throws out_of_range_exception if a feature contains indexes
+         *         that are not in the tables of its layer.
+         */
+        void add_layer(const layer& layer) {
+            if (layer.empty()) {
+                return;
+            }
+
+            std::string name{layer.name()};
+            auto it = m_layers.find(name);
+            if (it == m_layers.end()) {
+                it = m_layers.emplace(std::piecewise_construct,
+                                      std::forward_as_tuple(std::move(name)),
+                                      std::forward_as_tuple(*m_tile_builder, layer)).first;
+            }
+
+            merge_into(it->second, layer);
+        }
+
+        /**
+         * Merge all layers of a tile into the output tile.
+         *
+         * @param tile_data The encoded vector tile.
+         * @throws format_exception if the tile data is ill-formed.
+         * @throws any protozero exception if the protobuf encoding is
+         *         invalid.
+         */
+        void add_tile(const data_view tile_data) {
+            vector_tile tile{tile_data};
+            while (auto layer = tile.next_layer()) {
+                add_layer(layer);
+            }
+        }
+
+    }; // class tile_merger
+
+} // namespace vtzero
+
+#endif // VTZERO_MERGE_HPP
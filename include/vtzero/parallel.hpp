@@ -0,0 +1,228 @@
+#ifndef VTZERO_PARALLEL_HPP
+#define VTZERO_PARALLEL_HPP
+
+/*****************************************************************************
+
+vtzero - Tiny and fast vector tile decoder and encoder in C++.
+
+This file is from https://github.com/mapbox/vtzero where you can find more
+documentation.
+
+*****************************************************************************/
+
+/**
+ * @file parallel.hpp
+ *
+ * @brief Contains the for_each_feature_parallel() and
+ *        for_each_layer_parallel() functions.
+ *
+ * Everything else in vtzero is single-threaded, so this header is not
+ * included from vtzero.hpp. If you include it, you have to link with
+ * your system thread library.
+ */
+
+#include "feature.hpp"
+#include "layer.hpp"
+#include "vector_tile.hpp"
+
+#include <protozero/pbf_message.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vtzero {
+
+    /**
+     * Call a function for each feature in the specified layer using
+     * several threads.
+     *
+     * Before any thread is started, the key/value tables and the feature
+     * index of the layer are initialized from the calling thread. After
+     * that the layer is only read, so the threads can share it. The
+     * features are handed to the threads in chunks, a thread that is done
+     * with its chunk grabs the next one that no other thread has claimed
+     * yet.
+     *
+     * The function must be callable from several threads at the same time.
+     * Unlike with layer::for_each_feature() it can not stop the iteration,
+     * so it doesn't return a value. If it throws, the first exception
+     * thrown is rethrown from this function after all threads have
+     * finished.
+     *
+     * The order in which the features are seen is unspecified.
+     *
+     * @tparam TFunc The type of the function. It must take a single
+     *         argument of type feature&&.
+     * @param layer The layer with the features. Must stay valid until this
+     *        function returns.
+     * @param func The function to call for each feature.
+     * @param num_threads The number of threads to use. Defaults to the
+     *        number of cores reported by the system.
+     * @throws any exception thrown by the function or while decoding the
+     *         layer data.
+     * @pre @code layer.valid() @endcode
+     */
+    template <typename TFunc>
+    void for_each_feature_parallel(const layer& layer, TFunc&& func, std::size_t num_threads = std::thread::hardware_concurrency()) {
+        vtzero_assert(layer.valid());
+
+        // Touch the lazily initialized parts of the layer while we are
+        // still single-threaded.
+        layer.key_table();
+        layer.value_table();
+        layer.build_feature_index();
+
+        const std::size_t num_features = layer.num_features();
+
+        if (num_threads < 2 || num_features < 2) {
+            for (std::size_t n = 0; n < num_features; ++n) {
+                func(layer.get_feature(n));
+            }
+            return;
+        }
+
+        if (num_threads > num_features) {
+            num_threads = num_features;
+        }
+
+        // Chunks small enough to balance the load between the threads,
+        // large enough to keep the contention on the chunk counter low.
+        std::size_t chunk_size = num_features / (num_threads * 4);
+        if (chunk_size == 0) {
+            chunk_size = 1;
+        }
+
+        std::atomic<std::size_t> next_chunk{0};
+        std::exception_ptr first_exception;
+        std::mutex exception_mutex;
+
+        const auto worker = [&]() {
+            try {
+                while (true) {
+                    const std::size_t begin = next_chunk.fetch_add(chunk_size);
+                    if (begin >= num_features) {
+                        return;
+                    }
+                    std::size_t end = begin + chunk_size;
+                    if (end > num_features) {
+                        end = num_features;
+                    }
+                    for (std::size_t n = begin; n != end; ++n) {
+                        func(layer.get_feature(n));
+                    }
+                }
+            } catch (...) {
+                const std::lock_guard<std::mutex> lock{exception_mutex};
+                if (!first_exception) {
+                    first_exception = std::current_exception();
+                }
+            }
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(num_threads);
+        for (std::size_t n = 0; n < num_threads; ++n) {
+            threads.emplace_back(worker);
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        if (first_exception) {
+            std::rethrow_exception(first_exception);
+        }
+    }
+
+    /**
+     * Call a function for each layer in the specified tile using several
+     * threads.
+     *
+     * The layer data views are collected with one cheap scan over the tile
+     * envelope from the calling thread. After that each thread grabs the
+     * next unclaimed layer, constructs the layer object (which parses the
+     * layer envelope), and calls the function with it, so envelope parsing,
+     * table building, and feature decoding of independent layers overlap
+     * across cores.
+     *
+     * The function must be callable from several threads at the same time.
+     * Unlike with vector_tile::for_each_layer() it can not stop the
+     * iteration, so it doesn't return a value. If it throws, the first
+     * exception thrown is rethrown from this function after all threads
+     * have finished.
+     *
+     * The order in which the layers are seen is unspecified.
+     *
+     * @tparam TFunc The type of the function. It must take a single
+     *         argument of type layer&&.
+     * @param tile The vector tile. The data it references must stay valid
+     *        until this function returns.
+     * @param func The function to call for each layer.
+     * @param num_threads The number of threads to use. Defaults to the
+     *        number of cores reported by the system.
+     * @throws any exception thrown by the function or while decoding the
+     *         tile data.
+     */
+    template <typename TFunc>
+    void for_each_layer_parallel(const vector_tile& tile, TFunc&& func, std::size_t num_threads = std::thread::hardware_concurrency()) {
+        // Collect the layer data views with a cheap scan over the tile
+        // envelope while we are still single-threaded.
+        std::vector<data_view> layers;
+        protozero::pbf_message<detail::pbf_tile> tile_reader{tile.data()};
+        while (tile_reader.next(detail::pbf_tile::layers,
+                                protozero::pbf_wire_type::length_delimited)) {
+            layers.push_back(tile_reader.get_view());
+        }
+
+        if (num_threads < 2 || layers.size() < 2) {
+            for (const auto layer_data : layers) {
+                func(layer{layer_data});
+            }
+            return;
+        }
+
+        if (num_threads > layers.size()) {
+            num_threads = layers.size();
+        }
+
+        std::atomic<std::size_t> next_layer{0};
+        std::exception_ptr first_exception;
+        std::mutex exception_mutex;
+
+        const auto worker = [&]() {
+            try {
+                while (true) {
+                    const std::size_t n = next_layer.fetch_add(1);
+                    if (n >= layers.size()) {
+                        return;
+                    }
+                    func(layer{layers[n]});
+                }
+            } catch (...) {
+                const std::lock_guard<std::mutex> lock{exception_mutex};
+                if (!first_exception) {
+                    first_exception = std::current_exception();
+                }
+            }
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(num_threads);
+        for (std::size_t n = 0; n < num_threads; ++n) {
+            threads.emplace_back(worker);
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        if (first_exception) {
+            std::rethrow_exception(first_exception);
+        }
+    }
+
+} // namespace vtzero
+
+#endif // VTZERO_PARALLEL_HPP
@@ -13,12 +13,15 @@ documentation.
 /**
  * @file property_mapper.hpp
  *
- * @brief Contains the property_mapper class.
+ * @brief Contains the property_mapper and layer_remapper classes.
  */
 
 #include "builder.hpp"
+#include "feature.hpp"
 #include "layer.hpp"
 
+#include <protozero/pbf_builder.hpp>
+
 #include <vector>
 
 namespace vtzero {
@@ -96,8 +99,161 @@ namespace vtzero {
             return {map_key(idxs.key()), map_value(idxs.value())};
         }
 
+        /**
+         * Copy a feature including its ID, all its properties, and its
+         * geometry into the new layer. The geometry is copied as raw data,
+         * the property indexes are rewritten through map_key()/map_value(),
+         * so only the table entries actually referenced by copied features
+         * end up in the new layer.
+         *
+         * @param feature The feature to copy. It must come from the layer
+         *        this property_mapper was constructed with.
+         * @throws out_of_range_exception if the feature contains indexes
+         *         that are not in the tables of the existing layer.
+         */
+        void copy_feature(const feature& feature) {
+            auto& layer = m_layer_builder.get_layer_impl();
+            protozero::pbf_builder<detail::pbf_feature> feature_writer{layer.message(), detail::pbf_layer::features};
+
+            if (feature.has_id()) {
+                feature_writer.add_uint64(detail::pbf_feature::id, feature.id());
+            }
+
+            feature_writer.add_enum(detail::pbf_feature::type, static_cast<int32_t>(feature.geometry_type()));
+            feature_writer.add_string(detail::pbf_feature::geometry, feature.geometry().data());
+
+            if (!feature.empty()) {
+                protozero::packed_field_uint32 pbf_tags{feature_writer, detail::pbf_feature::tags};
+                feature.for_each_property_indexes([this, &pbf_tags](const index_value_pair idxs) {
+                    pbf_tags.add_element(map_key(idxs.key()).value());
+                    pbf_tags.add_element(map_value(idxs.value()).value());
+                    return true;
+                });
+            }
+
+            layer.increment_feature_count();
+        }
+
     }; // class property_mapper
 
+    /**
+     * Copies features from an existing layer into a new layer, rewriting
+     * their property indexes in bulk.
+     *
+     * In contrast to the property_mapper, which translates one key/value
+     * pair at a time through the builder API, this class copies the complete
+     * key and value tables of the existing layer into the new layer when it
+     * is constructed, building the old-to-new index translation tables once.
+     * Copying a feature is then a single pass over its packed tags array
+     * plus a raw copy of the encoded geometry, without decoding or
+     * re-encoding any properties. Use this when copying many features that
+     * reference (most of) the same table entries, for instance when
+     * subsetting a large layer.
+     *
+     * The new layer must not contain any keys or values yet when the
+     * layer_remapper is constructed.
+     */
+    class layer_remapper {
+
+        layer_builder& m_layer_builder;
+
+        std::vector<index_value> m_keys;
+        std::vector<index_value> m_values;
+
+    public:
+
+        /**
+         * Construct the remapper between the specified layers. This copies
+         * all entries of the key and value tables of the existing layer
+         * into the new layer.
+         *
+         * @param layer The existing layer from which features will be
+         *        copied.
+         * @param layer_builder The new layer that is being created.
+         */
+        layer_remapper(const layer& layer, vtzero::layer_builder& layer_builder) :
+            m_layer_builder(layer_builder) {
+            m_keys.reserve(layer.key_table().size());
+            for (const auto& key : layer.key_table()) {
+                m_keys.push_back(layer_builder.add_key_without_dup_check(key));
+            }
+            m_values.reserve(layer.value_table().size());
+            for (const auto& value : layer.value_table()) {
+                m_values.push_back(layer_builder.add_value_without_dup_check(value));
+            }
+        }
+
+        /**
+         * Copy a feature including its ID, all its properties, and its
+         * geometry into the new layer. The geometry is copied as raw data,
+         * the property indexes are rewritten using the translation tables
+         * computed in the constructor.
+         *
+         * @param feature The feature to copy. It must come from the layer
+         *        this layer_remapper was constructed with.
+         * @throws out_of_range_exception if the feature contains indexes
+         *         that are not in the tables of the existing layer.
+         */
+        void copy_feature(const feature& feature) {
+            auto& layer = m_layer_builder.get_layer_impl();
+            protozero::pbf_builder<detail::pbf_feature> feature_writer{layer.message(), detail::pbf_layer::features};
+
+            if (feature.has_id()) {
+                feature_writer.add_uint64(detail::pbf_feature::id, feature.id());
+            }
+
+            feature_writer.add_enum(detail::pbf_feature::type, static_cast<int32_t>(feature.geometry_type()));
+            feature_writer.add_string(detail::pbf_feature::geometry, feature.geometry().data());
+
+            if (!feature.empty()) {
+                protozero::packed_field_uint32 pbf_tags{feature_writer, detail::pbf_feature::tags};
+                feature.for_each_property_indexes([this, &pbf_tags](const index_value_pair idxs) {
+                    pbf_tags.add_element(m_keys[idxs.key().value()].value());
+                    pbf_tags.add_element(m_values[idxs.value().value()].value());
+                    return true;
+                });
+            }
+
+            layer.increment_feature_count();
+        }
+
+    }; // class layer_remapper
+
+    /**
+     * Copy the features of a layer for which a predicate returns true into
+     * a new layer in the specified tile. The new layer gets the same name,
+     * version, and extent as the existing layer.
+     *
+     * The surviving features' IDs and geometries are spliced as raw bytes
+     * and the key/value tables of the new layer are built up lazily
+     * through a property_mapper, so they only contain the entries actually
+     * referenced by surviving features. This is much cheaper than
+     * rebuilding features one by one through a feature builder, especially
+     * when most features survive.
+     *
+     * If no features survive, no layer is written to the tile.
+     *
+     * @tparam TPred The type of the predicate. It must take a single
+     *         argument of type const feature& and return a bool.
+     * @param layer The existing layer.
+     * @param pred The predicate deciding which features to keep.
+     * @param tile The tile builder the new layer is created in.
+     * @throws out_of_range_exception if a feature contains indexes that
+     *         are not in the tables of the existing layer.
+     */
+    template <typename TPred>
+    void subset_layer(const layer& layer, TPred&& pred, tile_builder& tile) {
+        vtzero::layer_builder layer_builder{tile, layer};
+        property_mapper mapper{layer, layer_builder};
+
+        layer.for_each_feature([&pred, &mapper](const feature& feature) {
+            if (pred(feature)) {
+                mapper.copy_feature(feature);
+            }
+            return true;
+        });
+    }
+
 } // namespace vtzero
 
 #endif // VTZERO_PROPERTY_MAPPER_HPP
@@ -0,0 +1,155 @@
+#ifndef VTZERO_RUNTIME_STATS_HPP
+#define VTZERO_RUNTIME_STATS_HPP
+
+/*****************************************************************************
+
+vtzero - Tiny and fast vector tile decoder and encoder in C++.
+
+This file is from https://github.com/mapbox/vtzero where you can find more
+documentation.
+
+*****************************************************************************/
+
+/**
+ * @file runtime_stats.hpp
+ *
+ * @brief Contains the runtime_stats struct and the snapshot_stats()
+ *        function.
+ *
+ * If the macro VTZERO_STATS is defined when compiling, vtzero counts
+ * in thread-local counters what it does on its hot paths: features and
+ * points decoded, key/value tables built, exceptions thrown, buffer
+ * reallocations while building, tiles serialized. The counters of the
+ * current thread can be read with snapshot_stats() and reset with
+ * reset_stats(). Without VTZERO_STATS the counters don't exist, the
+ * instrumentation compiles to nothing, and snapshot_stats() always
+ * returns zeros.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace vtzero {
+
+    /**
+     * Counters describing what vtzero did in the current thread. All
+     * counters stay zero unless the library was compiled with the macro
+     * VTZERO_STATS defined.
+     */
+    struct runtime_stats {
+
+        /// The number of features decoded.
+        uint64_t features_decoded = 0;
+
+        /// The number of geometries decoded.
+        uint64_t geometries_decoded = 0;
+
+        /// The number of points decoded in geometries.
+        uint64_t points_decoded = 0;
+
+        /// The number of key/value tables built by layers.
+        uint64_t table_builds = 0;
+
+        /// The number of vtzero exceptions thrown.
+        uint64_t exceptions_thrown = 0;
+
+        /// The number of builder table buffer reallocations.
+        uint64_t buffer_growths = 0;
+
+        /// The number of tiles serialized by the tile_builder.
+        uint64_t tiles_serialized = 0;
+
+    }; // struct runtime_stats
+
+#ifdef VTZERO_STATS
+
+    namespace detail {
+
+        inline runtime_stats& thread_stats() noexcept {
+            static thread_local runtime_stats stats{};
+            return stats;
+        }
+
+        // Increments the buffer_growths counter when the capacity of the
+        // buffer changes during the lifetime of this object.
+        class stats_growth_guard {
+
+            const std::string& m_buffer;
+            std::size_t m_capacity;
+
+        public:
+
+            explicit stats_growth_guard(const std::string& buffer) noexcept :
+                m_buffer(buffer),
+                m_capacity(buffer.capacity()) {
+            }
+
+            ~stats_growth_guard() noexcept {
+                if (m_buffer.capacity() != m_capacity) {
+                    ++thread_stats().buffer_growths;
+                }
+            }
+
+            stats_growth_guard(const stats_growth_guard&) = delete;
+            stats_growth_guard& operator=(const stats_growth_guard&) = delete;
+
+            stats_growth_guard(stats_growth_guard&&) = delete;
+            stats_growth_guard& operator=(stats_growth_guard&&) = delete;
+
+        }; // class stats_growth_guard
+
+    } // namespace detail
+
+/// @cond internal
+#define VTZERO_STATS_COUNT(counter) ++vtzero::detail::thread_stats().counter
+#define VTZERO_STATS_ADD(counter, amount) vtzero::detail::thread_stats().counter += (amount)
+#define VTZERO_STATS_GROWTH_GUARD(buffer) const vtzero::detail::stats_growth_guard vtzero_stats_growth_guard{buffer}
+/// @endcond
+
+    /**
+     * Get a copy of the runtime statistics counters of the current
+     * thread.
+     */
+    inline runtime_stats snapshot_stats() noexcept {
+        return detail::thread_stats();
+    }
+
+    /**
+     * Reset the runtime statistics counters of the current thread to
+     * zero.
+     */
+    inline void reset_stats() noexcept {
+        detail::thread_stats() = runtime_stats{};
+    }
+
+#else
+
+/// @cond internal
+#define VTZERO_STATS_COUNT(counter) static_cast<void>(0)
+#define VTZERO_STATS_ADD(counter, amount) static_cast<void>(0)
+#define VTZERO_STATS_GROWTH_GUARD(buffer) static_cast<void>(0)
+/// @endcond
+
+    /**
+     * Get a copy of the runtime statistics counters of the current
+     * thread. The library was compiled without VTZERO_STATS, so all
+     * counters are zero.
+     */
+    inline runtime_stats snapshot_stats() noexcept {
+        return runtime_stats{};
+    }
+
+    /**
+     * Reset the runtime statistics counters of the current thread to
+     * zero. The library was compiled without VTZERO_STATS, so this does
+     * nothing.
+     */
+    inline void reset_stats() noexcept {
+    }
+
+#endif
+
+} // namespace vtzero
+
+#endif // VTZERO_RUNTIME_STATS_HPP
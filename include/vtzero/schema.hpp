@@ -0,0 +1,168 @@
+#ifndef VTZERO_SCHEMA_HPP
+#define VTZERO_SCHEMA_HPP
+
+/*****************************************************************************
+
+vtzero - Tiny and fast vector tile decoder and encoder in C++.
+
+This file is from https://github.com/mapbox/vtzero where you can find more
+documentation.
+
+*****************************************************************************/
+
+/**
+ * @file schema.hpp
+ *
+ * @brief Contains the static_layer_builder template class.
+ */
+
+#include "builder.hpp"
+#include "encoded_property_value.hpp"
+#include "types.hpp"
+
+#include <protozero/pbf_builder.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace vtzero {
+
+    namespace detail {
+
+        template <typename TSchema>
+        std::string build_schema_keys_data() {
+            std::string data;
+            protozero::pbf_builder<detail::pbf_layer> pbf_keys{data};
+            for (const auto& key : TSchema::keys()) {
+                pbf_keys.add_string(detail::pbf_layer::keys, data_view{key});
+            }
+            return data;
+        }
+
+        template <typename TSchema>
+        std::string build_schema_values_data() {
+            std::string data;
+            protozero::pbf_builder<detail::pbf_layer> pbf_values{data};
+            for (const auto& value : TSchema::values()) {
+                pbf_values.add_string(detail::pbf_layer::values, value.data());
+            }
+            return data;
+        }
+
+        // The pre-encoded key table of a schema. It is built only once
+        // per schema type and kept in a function-local static.
+        template <typename TSchema>
+        const std::string& schema_keys_data() {
+            static const std::string data = build_schema_keys_data<TSchema>();
+            return data;
+        }
+
+        // The pre-encoded value table of a schema.
+        template <typename TSchema>
+        const std::string& schema_values_data() {
+            static const std::string data = build_schema_values_data<TSchema>();
+            return data;
+        }
+
+    } // namespace detail
+
+    /**
+     * A layer builder for layers with a fixed schema, ie. a known set of
+     * keys (and optionally values) in a known order.
+     *
+     * The schema is described by a type with the following members:
+     *
+     * @code
+     * struct road_schema {
+     *     static constexpr std::size_t num_keys = 3;
+     *     static constexpr std::size_t num_values = 1;
+     *     static const char* name() { return "roads"; }
+     *     static const std::array<const char*, num_keys>& keys() {
+     *         static const std::array<const char*, num_keys> keys{
+     *             {"class", "ref", "oneway"}};
+     *         return keys;
+     *     }
+     *     static const std::array<vtzero::encoded_property_value, num_values>& values() {
+     *         static const std::array<vtzero::encoded_property_value, num_values> values{
+     *             {vtzero::encoded_property_value{"primary"}}};
+     *         return values;
+     *     }
+     * };
+     * @endcode
+     *
+     * keys() and values() can return any containers usable in a range-for
+     * whose elements are convertible to data_view respectively have a
+     * data() member like encoded_property_value.
+     *
+     * The key and value tables of the schema are encoded only once per
+     * schema type and appended to every layer created with this builder
+     * as a single pre-encoded blob. The indexes of the schema entries are
+     * compile-time constants available through key() and value(), so
+     * writing a property from the schema doesn't do any hashing or table
+     * lookup:
+     *
+     * @code
+     * using roads_builder = vtzero::static_layer_builder<road_schema>;
+     * roads_builder lbuilder{tbuilder};
+     * vtzero::point_feature_builder fbuilder{lbuilder};
+     * ...
+     * fbuilder.add_property(roads_builder::key<0>(), roads_builder::value<0>());
+     * @endcode
+     *
+     * This is still a normal layer_builder, so properties outside the
+     * schema can be added through the usual dynamic interface. The
+     * duplicate checks in add_key()/add_value() see the schema entries,
+     * so adding a schema key dynamically returns its schema index.
+     */
+    template <typename TSchema>
+    class static_layer_builder : public layer_builder {
+
+    public:
+
+        /**
+         * Construct a static_layer_builder in the specified tile. The
+         * name of the layer is taken from the schema.
+         *
+         * @param tile The tile builder we want to create this layer in.
+         * @param version The vector tile spec version of the new layer.
+         * @param extent The extent of the new layer.
+         */
+        explicit static_layer_builder(vtzero::tile_builder& tile, uint32_t version = 2, uint32_t extent = 4096) :
+            layer_builder(tile, TSchema::name(), version, extent) {
+            auto& layer = get_layer_impl();
+            layer.append_keys_data(detail::schema_keys_data<TSchema>(),
+                                   static_cast<uint32_t>(TSchema::num_keys));
+            layer.append_values_data(detail::schema_values_data<TSchema>(),
+                                     static_cast<uint32_t>(TSchema::num_values));
+        }
+
+        /**
+         * The index of the key at the specified position in the schema.
+         *
+         * @tparam TIndex The position of the key in the schema. Checked
+         *         at compile time.
+         */
+        template <std::size_t TIndex>
+        static index_value key() noexcept {
+            static_assert(TIndex < TSchema::num_keys, "key index out of range for this schema");
+            return index_value{static_cast<uint32_t>(TIndex)};
+        }
+
+        /**
+         * The index of the value at the specified position in the schema.
+         *
+         * @tparam TIndex The position of the value in the schema. Checked
+         *         at compile time.
+         */
+        template <std::size_t TIndex>
+        static index_value value() noexcept {
+            static_assert(TIndex < TSchema::num_values, "value index out of range for this schema");
+            return index_value{static_cast<uint32_t>(TIndex)};
+        }
+
+    }; // class static_layer_builder
+
+} // namespace vtzero
+
+#endif // VTZERO_SCHEMA_HPP
@@ -0,0 +1,163 @@
+#ifndef VTZERO_SIMPLIFY_HPP
+#define VTZERO_SIMPLIFY_HPP
+
+/*****************************************************************************
+
+vtzero - Tiny and fast vector tile decoder and encoder in C++.
+
+This file is from https://github.com/mapbox/vtzero where you can find more
+documentation.
+
+*****************************************************************************/
+
+/**
+ * @file simplify.hpp
+ *
+ * @brief Contains the simplify_linestring_handler class.
+ */
+
+#include "geometry.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace vtzero {
+
+    /**
+     * A geometry handler wrapping another geometry handler. Each linestring
+     * is simplified using the Douglas-Peucker algorithm with the specified
+     * tolerance before it is forwarded, so the wrapped handler only ever
+     * sees (and allocates for) the surviving points.
+     *
+     * @code
+     * my_handler handler;
+     * vtzero::simplify_linestring_handler<my_handler> simplifier{handler, 2.0};
+     * vtzero::decode_linestring_geometry(feature.geometry(), simplifier);
+     * @endcode
+     *
+     * Douglas-Peucker needs the complete linestring, so the points of the
+     * current linestring are buffered internally. The buffer is reused
+     * between linestrings, use a single simplify_linestring_handler for
+     * many features to avoid allocations.
+     *
+     * The first and last point of a linestring are always kept.
+     *
+     * @tparam TGeomHandler The wrapped handler class. See tutorial for
+     *         details.
+     */
+    template <typename TGeomHandler>
+    class simplify_linestring_handler {
+
+        TGeomHandler* m_handler;
+        std::vector<point> m_points{};
+        std::vector<char> m_keep{};
+        std::vector<std::pair<std::size_t, std::size_t>> m_stack{};
+        double m_squared_tolerance;
+
+        static double squared_chord_distance(const point a, const point b, const point p) noexcept {
+            const double abx = static_cast<double>(b.x) - a.x;
+            const double aby = static_cast<double>(b.y) - a.y;
+            const double apx = static_cast<double>(p.x) - a.x;
+            const double apy = static_cast<double>(p.y) - a.y;
+
+            const double squared_length = abx * abx + aby * aby;
+            if (squared_length == 0.0) {
+                return apx * apx + apy * apy;
+            }
+
+            const double cross = abx * apy - aby * apx;
+            return cross * cross / squared_length;
+        }
+
+        void simplify() {
+            const std::size_t size = m_points.size();
+
+            m_keep.assign(size, 1);
+            if (size <= 2 || m_squared_tolerance <= 0.0) {
+                return;
+            }
+
+            m_keep.assign(size, 0);
+            m_keep.front() = 1;
+            m_keep.back() = 1;
+
+            m_stack.clear();
+            m_stack.emplace_back(0, size - 1);
+            while (!m_stack.empty()) {
+                const auto range = m_stack.back();
+                m_stack.pop_back();
+
+                double max_squared_distance = m_squared_tolerance;
+                std::size_t index = 0;
+                for (std::size_t i = range.first + 1; i < range.second; ++i) {
+                    const double squared_distance = squared_chord_distance(m_points[range.first], m_points[range.second], m_points[i]);
+                    if (squared_distance > max_squared_distance) {
+                        max_squared_distance = squared_distance;
+                        index = i;
+                    }
+                }
+
+                if (index != 0) {
+                    m_keep[index] = 1;
+                    if (index - range.first > 1) {
+                        m_stack.emplace_back(range.first, index);
+                    }
+                    if (range.second - index > 1) {
+                        m_stack.emplace_back(index, range.second);
+                    }
+                }
+            }
+        }
+
+    public:
+
+        /**
+         * Constructor.
+         *
+         * @param handler The handler the simplified linestrings are
+         *        forwarded to. Must stay valid as long as this object is
+         *        used.
+         * @param tolerance Maximum allowed perpendicular distance (in tile
+         *        coordinate units) between a dropped point and the
+         *        simplified linestring. A tolerance of 0 keeps all points.
+         */
+        simplify_linestring_handler(TGeomHandler& handler, const double tolerance) noexcept :
+            m_handler(&handler),
+            m_squared_tolerance(tolerance * tolerance) {
+        }
+
+        /// @cond internal
+        void linestring_begin(const uint32_t count) {
+            m_points.clear();
+            m_points.reserve(count);
+        }
+
+        void linestring_point(const point p) {
+            m_points.push_back(p);
+        }
+
+        void linestring_end() {
+            simplify();
+
+            uint32_t count = 0;
+            for (const char keep : m_keep) {
+                count += static_cast<uint32_t>(keep);
+            }
+
+            m_handler->linestring_begin(count);
+            for (std::size_t i = 0; i < m_points.size(); ++i) {
+                if (m_keep[i]) {
+                    m_handler->linestring_point(m_points[i]);
+                }
+            }
+            m_handler->linestring_end();
+        }
+        /// @endcond
+
+    }; // class simplify_linestring_handler
+
+} // namespace vtzero
+
+#endif // VTZERO_SIMPLIFY_HPP
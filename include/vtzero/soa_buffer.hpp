@@ -0,0 +1,253 @@
+#ifndef VTZERO_SOA_BUFFER_HPP
+#define VTZERO_SOA_BUFFER_HPP
+
+/*****************************************************************************
+
+vtzero - Tiny and fast vector tile decoder and encoder in C++.
+
+This file is from https://github.com/mapbox/vtzero where you can find more
+documentation.
+
+*****************************************************************************/
+
+/**
+ * @file soa_buffer.hpp
+ *
+ * @brief Contains the soa_buffer class and the decode_to_soa() function.
+ */
+
+#include "geometry.hpp"
+#include "types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace vtzero {
+
+    namespace detail {
+
+        class soa_appender;
+
+    } // namespace detail
+
+    /**
+     * Stores a decoded geometry in struct-of-arrays form: one flat array
+     * for the x coordinates, one for the y coordinates, and an offset
+     * table describing where the parts (points, linestrings, or rings)
+     * begin.
+     *
+     * Use this together with the decode_to_soa() function if you want
+     * flat coordinate arrays instead of implementing a geometry handler:
+     *
+     * @code
+     *   vtzero::soa_buffer buffer;
+     *   vtzero::decode_to_soa(feature.geometry(), buffer);
+     *   for (std::size_t part = 0; part < buffer.num_parts(); ++part) {
+     *     for (std::size_t n = buffer.part_begin(part); n < buffer.part_end(part); ++n) {
+     *       ... buffer.x()[n] ... buffer.y()[n] ...
+     *     }
+     *   }
+     * @endcode
+     *
+     * The internal arrays keep their capacity when the buffer is reused
+     * for the next feature, so decoding many features into the same
+     * soa_buffer doesn't allocate any memory once the arrays are large
+     * enough.
+     */
+    class soa_buffer {
+
+        friend class detail::soa_appender;
+
+        friend GeomType decode_to_soa(const geometry& geometry, soa_buffer& buffer);
+
+        std::vector<int32_t> m_x{};
+        std::vector<int32_t> m_y{};
+        std::vector<std::size_t> m_offsets{};
+        std::vector<ring_type> m_ring_types{};
+        GeomType m_type = GeomType::UNKNOWN;
+
+    public:
+
+        /// Construct an empty soa_buffer.
+        soa_buffer() = default;
+
+        /**
+         * Remove all data from this buffer. The capacity of the internal
+         * arrays is retained.
+         */
+        void clear() noexcept {
+            m_x.clear();
+            m_y.clear();
+            m_offsets.clear();
+            m_ring_types.clear();
+            m_type = GeomType::UNKNOWN;
+        }
+
+        /**
+         * The type of the geometry stored in this buffer. Returns
+         * GeomType::UNKNOWN if no geometry was decoded into this buffer
+         * yet.
+         */
+        GeomType geometry_type() const noexcept {
+            return m_type;
+        }
+
+        /// The number of points stored in this buffer.
+        std::size_t num_points() const noexcept {
+            return m_x.size();
+        }
+
+        /**
+         * The number of parts stored in this buffer. For point geometries
+         * this is always 1, for linestrings it is the number of
+         * linestrings, for polygons the number of rings.
+         */
+        std::size_t num_parts() const noexcept {
+            return m_offsets.empty() ? 0 : m_offsets.size() - 1;
+        }
+
+        /// The x coordinates of all points.
+        const std::vector<int32_t>& x() const noexcept {
+            return m_x;
+        }
+
+        /// The y coordinates of all points.
+        const std::vector<int32_t>& y() const noexcept {
+            return m_y;
+        }
+
+        /**
+         * The offset table. Contains the index of the first point of
+         * each part followed by one extra entry with the total number of
+         * points, so part *n* covers the points at indexes
+         * [offsets()[n], offsets()[n + 1]).
+         */
+        const std::vector<std::size_t>& offsets() const noexcept {
+            return m_offsets;
+        }
+
+        /**
+         * The ring type of each ring. Only filled for polygon
+         * geometries where it has one entry per part.
+         */
+        const std::vector<ring_type>& ring_types() const noexcept {
+            return m_ring_types;
+        }
+
+        /**
+         * Index of the first point of the specified part.
+         *
+         * @pre @code part < num_parts() @endcode
+         */
+        std::size_t part_begin(std::size_t part) const noexcept {
+            vtzero_assert_in_noexcept_function(part < num_parts());
+            return m_offsets[part];
+        }
+
+        /**
+         * Index one past the last point of the specified part.
+         *
+         * @pre @code part < num_parts() @endcode
+         */
+        std::size_t part_end(std::size_t part) const noexcept {
+            vtzero_assert_in_noexcept_function(part < num_parts());
+            return m_offsets[part + 1];
+        }
+
+    }; // class soa_buffer
+
+    namespace detail {
+
+        /**
+         * A geometry handler writing all points into the flat arrays of
+         * a soa_buffer.
+         */
+        class soa_appender {
+
+            soa_buffer& m_buffer;
+
+            void add_part(const uint32_t count) {
+                m_buffer.m_offsets.push_back(m_buffer.m_x.size());
+                m_buffer.m_x.reserve(m_buffer.m_x.size() + count);
+                m_buffer.m_y.reserve(m_buffer.m_y.size() + count);
+            }
+
+            void add_point(const point p) {
+                m_buffer.m_x.push_back(p.x);
+                m_buffer.m_y.push_back(p.y);
+            }
+
+        public:
+
+            explicit soa_appender(soa_buffer& buffer) noexcept :
+                m_buffer(buffer) {
+            }
+
+            /// @cond internal
+            void points_begin(const uint32_t count) {
+                add_part(count);
+            }
+
+            void points_point(const point p) {
+                add_point(p);
+            }
+
+            void points_end() const noexcept {
+            }
+
+            void linestring_begin(const uint32_t count) {
+                add_part(count);
+            }
+
+            void linestring_point(const point p) {
+                add_point(p);
+            }
+
+            void linestring_end() const noexcept {
+            }
+
+            void ring_begin(const uint32_t count) {
+                add_part(count);
+            }
+
+            void ring_point(const point p) {
+                add_point(p);
+            }
+
+            void ring_end(const ring_type rt) {
+                m_buffer.m_ring_types.push_back(rt);
+            }
+            /// @endcond
+
+        }; // class soa_appender
+
+    } // namespace detail
+
+    /**
+     * Decode a geometry into the flat arrays of a soa_buffer. Any data
+     * in the buffer from a previous call is removed first, the capacity
+     * of its internal arrays is reused.
+     *
+     * @param geometry The geometry as returned by feature.geometry().
+     * @param buffer The buffer the decoded geometry is written to.
+     * @returns The type of the decoded geometry.
+     * @throws geometry_exception If the geometry has type UNKNOWN or if
+     *         there is a problem with the geometry. The contents of the
+     *         buffer are undefined in this case.
+     */
+    inline GeomType decode_to_soa(const geometry& geometry, soa_buffer& buffer) {
+        buffer.clear();
+        decode_geometry(geometry, detail::soa_appender{buffer});
+        buffer.m_type = geometry.type();
+
+        // Add the extra offset entry, so users can always get the end of
+        // a part from the offset table.
+        buffer.m_offsets.push_back(buffer.num_points());
+
+        return geometry.type();
+    }
+
+} // namespace vtzero
+
+#endif // VTZERO_SOA_BUFFER_HPP
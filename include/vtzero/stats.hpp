@@ -0,0 +1,147 @@
+#ifndef VTZERO_STATS_HPP
+#define VTZERO_STATS_HPP
+
+/*****************************************************************************
+
+vtzero - Tiny and fast vector tile decoder and encoder in C++.
+
+This file is from https://github.com/mapbox/vtzero where you can find more
+documentation.
+
+*****************************************************************************/
+
+/**
+ * @file stats.hpp
+ *
+ * @brief Contains the scan_stats() function and the statistics structs.
+ */
+
+#include "types.hpp"
+
+#include <protozero/pbf_message.hpp>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace vtzero {
+
+    /**
+     * Statistics about a single layer as computed by scan_stats().
+     */
+    struct layer_stats {
+
+        /**
+         * The name of the layer. This points into the tile data the stats
+         * were computed from, which has to stay valid as long as the name
+         * is used.
+         */
+        data_view name{};
+
+        /// The version of the layer.
+        uint32_t version = 1;
+
+        /// The extent of the layer.
+        uint32_t extent = 4096;
+
+        /// The number of features in the layer.
+        uint64_t num_features = 0;
+
+        /// The size of the encoded layer in bytes.
+        uint64_t raw_size = 0;
+
+        /// The sum of the sizes of all encoded feature geometries in bytes.
+        uint64_t geometries_size = 0;
+
+        /// The number of entries in the key table.
+        uint64_t key_table_size = 0;
+
+        /// The number of entries in the value table.
+        uint64_t value_table_size = 0;
+
+    }; // struct layer_stats
+
+    /**
+     * Statistics about a tile as computed by scan_stats().
+     */
+    struct tile_stats {
+
+        /// The per-layer statistics in the order the layers appear.
+        std::vector<layer_stats> layers{};
+
+        /**
+         * Histogram of layer versions: layers_by_version[v] is the number
+         * of layers with version v for v in 1..3, layers_by_version[0]
+         * counts layers with any other version.
+         */
+        std::array<uint64_t, 4> layers_by_version{{0, 0, 0, 0}};
+
+    }; // struct tile_stats
+
+    /**
+     * Compute statistics about a tile in a single pass over the encoded
+     * data. Unlike going through vector_tile/layer/feature this never
+     * materializes the key/value tables or any feature objects, so apart
+     * from one vector with an entry per layer nothing is allocated. Use
+     * this for statistics jobs over many tiles.
+     *
+     * No validation beyond the protobuf structure is done; in particular
+     * unknown fields are skipped, not rejected.
+     *
+     * @param tile_data The encoded vector tile.
+     * @returns The statistics for this tile.
+     * @throws any protozero exception if the protobuf encoding is invalid.
+     */
+    inline tile_stats scan_stats(const data_view tile_data) {
+        tile_stats stats{};
+
+        protozero::pbf_message<detail::pbf_tile> tile_reader{tile_data};
+        while (tile_reader.next(detail::pbf_tile::layers, protozero::pbf_wire_type::length_delimited)) {
+            const auto layer_data = tile_reader.get_view();
+
+            layer_stats lstats{};
+            lstats.raw_size = layer_data.size();
+
+            protozero::pbf_message<detail::pbf_layer> layer_reader{layer_data};
+            while (layer_reader.next()) {
+                switch (layer_reader.tag_and_type()) {
+                    case protozero::tag_and_type(detail::pbf_layer::version, protozero::pbf_wire_type::varint):
+                        lstats.version = layer_reader.get_uint32();
+                        break;
+                    case protozero::tag_and_type(detail::pbf_layer::name, protozero::pbf_wire_type::length_delimited):
+                        lstats.name = layer_reader.get_view();
+                        break;
+                    case protozero::tag_and_type(detail::pbf_layer::features, protozero::pbf_wire_type::length_delimited): {
+                            ++lstats.num_features;
+                            protozero::pbf_message<detail::pbf_feature> feature_reader{layer_reader.get_view()};
+                            while (feature_reader.next(detail::pbf_feature::geometry, protozero::pbf_wire_type::length_delimited)) {
+                                lstats.geometries_size += feature_reader.get_view().size();
+                            }
+                        }
+                        break;
+                    case protozero::tag_and_type(detail::pbf_layer::keys, protozero::pbf_wire_type::length_delimited):
+                        ++lstats.key_table_size;
+                        layer_reader.skip();
+                        break;
+                    case protozero::tag_and_type(detail::pbf_layer::values, protozero::pbf_wire_type::length_delimited):
+                        ++lstats.value_table_size;
+                        layer_reader.skip();
+                        break;
+                    case protozero::tag_and_type(detail::pbf_layer::extent, protozero::pbf_wire_type::varint):
+                        lstats.extent = layer_reader.get_uint32();
+                        break;
+                    default:
+                        layer_reader.skip(); // ignore unknown fields
+                }
+            }
+
+            ++stats.layers_by_version[lstats.version <= 3 ? lstats.version : 0];
+            stats.layers.push_back(lstats);
+        }
+
+        return stats;
+    }
+
+} // namespace vtzero
+
+#endif // VTZERO_STATS_HPP
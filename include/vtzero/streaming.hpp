@@ -0,0 +1,155 @@
+#ifndef VTZERO_STREAMING_HPP
+#define VTZERO_STREAMING_HPP
+
+/*****************************************************************************
+
+vtzero - Tiny and fast vector tile decoder and encoder in C++.
+
+This file is from https://github.com/mapbox/vtzero where you can find more
+documentation.
+
+*****************************************************************************/
+
+/**
+ * @file streaming.hpp
+ *
+ * @brief Contains the streaming_tile_decoder class.
+ */
+
+#include "exception.hpp"
+#include "layer.hpp"
+#include "types.hpp"
+
+#include <protozero/exception.hpp>
+#include <protozero/pbf_message.hpp>
+
+#include <cstddef>
+#include <string>
+#include <utility>
+
+namespace vtzero {
+
+    /**
+     * Incremental decoder for tile data arriving in chunks.
+     *
+     * The vector_tile class needs the complete tile data in one buffer
+     * before decoding can start. When the data comes in over the network
+     * (and possibly through a decompressor) that means buffering the whole
+     * tile first. The streaming_tile_decoder instead takes the data chunk
+     * by chunk, in whatever sizes the upstream source delivers, and hands
+     * each layer to a callback as soon as all bytes of that layer have
+     * arrived. Decoding is pipelined with the arrival of the data and at
+     * most one (partial) layer is buffered internally at any time.
+     *
+     * @code
+     * vtzero::streaming_tile_decoder decoder;
+     * while (auto chunk = read_next_chunk()) {
+     *     decoder.add_chunk(chunk, [&](vtzero::layer&& layer) {
+     *         handle(layer);
+     *     });
+     * }
+     * decoder.finish(); // throws if the data ended mid-layer
+     * @endcode
+     *
+     * The layers handed to the callback (and all features from them) are
+     * only valid during that call to the callback, because they can point
+     * into the chunk or into an internal buffer that is reused afterwards.
+     */
+    class streaming_tile_decoder {
+
+        // Bytes from previous chunks that didn't form a complete record
+        // yet. Empty as long as records happen to end on chunk boundaries,
+        // in which case the layers are decoded straight out of the chunks
+        // without a copy.
+        std::string m_buffer{};
+
+        void stash_remaining(const data_view data, const std::size_t remaining) {
+            if (m_buffer.empty()) {
+                m_buffer.assign(data.data() + (data.size() - remaining), remaining);
+                return;
+            }
+            // The data is m_buffer itself, remove the consumed prefix.
+            m_buffer.erase(0, m_buffer.size() - remaining);
+        }
+
+    public:
+
+        streaming_tile_decoder() = default;
+
+        /**
+         * Add the next chunk of tile data, calling a function for every
+         * layer that is now complete. A chunk can contain any number of
+         * layers including none at all, the chunk sizes don't have to
+         * line up with the layers in any way.
+         *
+         * @tparam TFunc The type of the function. It must take a single
+         *         argument of type layer&&.
+         * @param chunk The next piece of the tile data.
+         * @param func The function to call for each complete layer.
+         * @throws any exception thrown by the function or while decoding
+         *         the tile data.
+         */
+        template <typename TFunc>
+        void add_chunk(const data_view chunk, TFunc&& func) {
+            data_view data = chunk;
+            if (!m_buffer.empty()) {
+                m_buffer.append(chunk.data(), chunk.size());
+                data = data_view{m_buffer};
+            }
+
+            protozero::pbf_message<detail::pbf_tile> reader{data};
+            std::size_t remaining = data.size();
+            try {
+                while (reader.next(detail::pbf_tile::layers,
+                                   protozero::pbf_wire_type::length_delimited)) {
+                    const auto layer_data = reader.get_view();
+                    remaining = reader.length();
+                    func(layer{layer_data});
+                }
+                remaining = reader.length();
+            } catch (const protozero::end_of_buffer_exception&) {
+                // The last record is still incomplete, keep its bytes
+                // until the next chunk arrives.
+            }
+
+            if (remaining == 0) {
+                m_buffer.clear();
+            } else {
+                stash_remaining(data, remaining);
+            }
+        }
+
+        /**
+         * Tell the decoder that the tile data is complete.
+         *
+         * @throws format_exception if there are leftover bytes that don't
+         *         form a complete layer, ie. the tile data was truncated
+         *         or corrupt.
+         */
+        void finish() const {
+            if (!m_buffer.empty()) {
+                throw format_exception{"tile data ends with incomplete layer"};
+            }
+        }
+
+        /**
+         * The number of bytes buffered internally, ie. the size of the
+         * incomplete record at the end of the data seen so far.
+         */
+        std::size_t buffered_size() const noexcept {
+            return m_buffer.size();
+        }
+
+        /**
+         * Reset the decoder so it can be used for the next tile. The
+         * capacity of the internal buffer is retained.
+         */
+        void reset() noexcept {
+            m_buffer.clear();
+        }
+
+    }; // class streaming_tile_decoder
+
+} // namespace vtzero
+
+#endif // VTZERO_STREAMING_HPP
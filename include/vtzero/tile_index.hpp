@@ -0,0 +1,311 @@
+#ifndef VTZERO_TILE_INDEX_HPP
+#define VTZERO_TILE_INDEX_HPP
+
+/*****************************************************************************
+
+vtzero - Tiny and fast vector tile decoder and encoder in C++.
+
+This file is from https://github.com/mapbox/vtzero where you can find more
+documentation.
+
+*****************************************************************************/
+
+/**
+ * @file tile_index.hpp
+ *
+ * @brief Contains the build_tile_index() function and the tile_index class.
+ */
+
+#include "exception.hpp"
+#include "layer.hpp"
+#include "types.hpp"
+
+#include <protozero/pbf_builder.hpp>
+#include <protozero/pbf_message.hpp>
+#include <protozero/varint.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace vtzero {
+
+    namespace detail {
+
+        /// The tags of the sidecar tile index message.
+        enum class pbf_tile_index : protozero::pbf_tag_type {
+            version = 1,
+            layers  = 2
+        };
+
+        /// The tags of the per-layer entry in the tile index.
+        enum class pbf_layer_index : protozero::pbf_tag_type {
+            offset          = 1,
+            size            = 2,
+            feature_offsets = 3, // packed, delta encoded, relative to the layer
+            feature_sizes   = 4, // packed
+            id_positions    = 5, // packed, delta encoded
+            ids             = 6  // packed
+        };
+
+        /// The version of the sidecar tile index format written and read.
+        constexpr const uint32_t tile_index_version = 1;
+
+    } // namespace detail
+
+    /**
+     * Build sidecar index data for the specified tile.
+     *
+     * The returned blob contains, for every layer of the tile, the offset
+     * and size of the layer data and the offsets, sizes, and (where
+     * present) IDs of all its features, with the offsets delta encoded as
+     * varints to keep it compact. Store it next to the tile (for instance
+     * in an extra column of a tile archive). Loading it with the
+     * tile_index class later gives access to the layers of the tile with
+     * their feature indexes already populated, without the per-feature
+     * envelope scan that build_feature_index() needs.
+     *
+     * The index describes the exact bytes of the tile data, it is invalid
+     * for any other (for instance re-encoded) version of the tile.
+     *
+     * @param tile_data The tile data to index.
+     * @returns The encoded index data.
+     * @throws any protozero exception if the protobuf encoding is invalid.
+     */
+    inline std::string build_tile_index(const data_view tile_data) {
+        std::string index_data;
+        protozero::pbf_builder<detail::pbf_tile_index> builder{index_data};
+        builder.add_uint32(detail::pbf_tile_index::version, detail::tile_index_version);
+
+        std::string entry;
+        protozero::pbf_message<detail::pbf_tile> tile_reader{tile_data};
+        while (tile_reader.next(detail::pbf_tile::layers,
+                                protozero::pbf_wire_type::length_delimited)) {
+            const auto layer_data = tile_reader.get_view();
+
+            entry.clear();
+            protozero::pbf_builder<detail::pbf_layer_index> layer_builder{entry};
+            layer_builder.add_uint32(detail::pbf_layer_index::offset,
+                                     static_cast<uint32_t>(layer_data.data() - tile_data.data()));
+            layer_builder.add_uint32(detail::pbf_layer_index::size,
+                                     static_cast<uint32_t>(layer_data.size()));
+
+            std::vector<uint32_t> offsets;
+            std::vector<uint32_t> sizes;
+            std::vector<uint32_t> id_positions;
+            std::vector<uint64_t> ids;
+
+            protozero::pbf_message<detail::pbf_layer> layer_reader{layer_data};
+            while (layer_reader.next(detail::pbf_layer::features,
+                                     protozero::pbf_wire_type::length_delimited)) {
+                const auto feature_data = layer_reader.get_view();
+                offsets.push_back(static_cast<uint32_t>(feature_data.data() - layer_data.data()));
+                sizes.push_back(static_cast<uint32_t>(feature_data.size()));
+
+                protozero::pbf_message<detail::pbf_feature> feature_reader{feature_data};
+                if (feature_reader.next(detail::pbf_feature::id,
+                                        protozero::pbf_wire_type::varint)) {
+                    id_positions.push_back(static_cast<uint32_t>(offsets.size() - 1));
+                    ids.push_back(feature_reader.get_uint64());
+                }
+            }
+
+            if (!offsets.empty()) {
+                {
+                    protozero::packed_field_uint32 field{layer_builder, static_cast<protozero::pbf_tag_type>(detail::pbf_layer_index::feature_offsets)};
+                    uint32_t last = 0;
+                    for (const auto offset : offsets) {
+                        field.add_element(offset - last);
+                        last = offset;
+                    }
+                }
+                {
+                    protozero::packed_field_uint32 field{layer_builder, static_cast<protozero::pbf_tag_type>(detail::pbf_layer_index::feature_sizes)};
+                    for (const auto size : sizes) {
+                        field.add_element(size);
+                    }
+                }
+            }
+            if (!ids.empty()) {
+                {
+                    protozero::packed_field_uint32 field{layer_builder, static_cast<protozero::pbf_tag_type>(detail::pbf_layer_index::id_positions)};
+                    uint32_t last = 0;
+                    for (const auto pos : id_positions) {
+                        field.add_element(pos - last);
+                        last = pos;
+                    }
+                }
+                {
+                    protozero::packed_field_uint64 field{layer_builder, static_cast<protozero::pbf_tag_type>(detail::pbf_layer_index::ids)};
+                    for (const auto id : ids) {
+                        field.add_element(id);
+                    }
+                }
+            }
+
+            builder.add_message(detail::pbf_tile_index::layers, entry);
+        }
+
+        return index_data;
+    }
+
+    /**
+     * Access to a tile through its sidecar index data (see
+     * build_tile_index()).
+     *
+     * The constructor only decodes the index, it never scans the tile
+     * data itself. The layers it hands out have their feature index (as
+     * built by layer::build_feature_index()) already populated, so
+     * get_feature() and get_feature_by_id() work in constant time right
+     * away.
+     *
+     * Both the tile data and the index data must stay valid as long as
+     * the tile_index or any layer or feature from it is used.
+     */
+    class tile_index {
+
+        std::vector<layer> m_layers;
+
+    public:
+
+        /**
+         * Construct the tile_index from the tile data and the sidecar
+         * index data describing it.
+         *
+         * @param tile_data The tile data.
+         * @param index_data The index data created by build_tile_index()
+         *        from exactly this tile data.
+         * @throws format_exception if the index data has an unknown
+         *         version or does not fit the tile data.
+         * @throws any protozero exception if the protobuf encoding is
+         *         invalid.
+         */
+        tile_index(const data_view tile_data, const data_view index_data) {
+            protozero::pbf_message<detail::pbf_tile_index> reader{index_data};
+            while (reader.next()) {
+                switch (reader.tag_and_type()) {
+                    case protozero::tag_and_type(detail::pbf_tile_index::version, protozero::pbf_wire_type::varint):
+                        if (reader.get_uint32() != detail::tile_index_version) {
+                            throw format_exception{"unknown tile index version"};
+                        }
+                        break;
+                    case protozero::tag_and_type(detail::pbf_tile_index::layers, protozero::pbf_wire_type::length_delimited): {
+                        add_layer(tile_data, reader.get_view());
+                        break;
+                    }
+                    default:
+                        reader.skip(); // ignore unknown fields
+                }
+            }
+        }
+
+        /// The number of layers in the tile.
+        std::size_t num_layers() const noexcept {
+            return m_layers.size();
+        }
+
+        /**
+         * Get the layer with the specified zero-based index. The feature
+         * index of the layer is already populated.
+         *
+         * @returns The specified layer or the invalid layer if the index
+         *          is out of range.
+         */
+        layer get_layer(const std::size_t index) const {
+            if (index >= m_layers.size()) {
+                return layer{};
+            }
+            return m_layers[index];
+        }
+
+    private:
+
+        void add_layer(const data_view tile_data, const data_view entry) {
+            uint32_t offset = 0;
+            uint32_t size = 0;
+            protozero::iterator_range<protozero::pbf_reader::const_uint32_iterator> offsets;
+            protozero::iterator_range<protozero::pbf_reader::const_uint32_iterator> sizes;
+            protozero::iterator_range<protozero::pbf_reader::const_uint32_iterator> id_positions;
+            data_view ids_data{};
+
+            protozero::pbf_message<detail::pbf_layer_index> reader{entry};
+            while (reader.next()) {
+                switch (reader.tag_and_type()) {
+                    case protozero::tag_and_type(detail::pbf_layer_index::offset, protozero::pbf_wire_type::varint):
+                        offset = reader.get_uint32();
+                        break;
+                    case protozero::tag_and_type(detail::pbf_layer_index::size, protozero::pbf_wire_type::varint):
+                        size = reader.get_uint32();
+                        break;
+                    case protozero::tag_and_type(detail::pbf_layer_index::feature_offsets, protozero::pbf_wire_type::length_delimited):
+                        offsets = reader.get_packed_uint32();
+                        break;
+                    case protozero::tag_and_type(detail::pbf_layer_index::feature_sizes, protozero::pbf_wire_type::length_delimited):
+                        sizes = reader.get_packed_uint32();
+                        break;
+                    case protozero::tag_and_type(detail::pbf_layer_index::id_positions, protozero::pbf_wire_type::length_delimited):
+                        id_positions = reader.get_packed_uint32();
+                        break;
+                    case protozero::tag_and_type(detail::pbf_layer_index::ids, protozero::pbf_wire_type::length_delimited):
+                        ids_data = reader.get_view();
+                        break;
+                    default:
+                        reader.skip(); // ignore unknown fields
+                }
+            }
+
+            if (offset > tile_data.size() || size > tile_data.size() - offset) {
+                throw format_exception{"tile index does not fit the tile data"};
+            }
+            const data_view layer_data{tile_data.data() + offset, size};
+
+            layer new_layer{layer_data};
+
+            // Un-delta the feature offsets and rebuild the feature index
+            // the same way layer::build_feature_index() would.
+            uint32_t feature_offset = 0;
+            auto size_it = sizes.begin();
+            for (auto it = offsets.begin(); it != offsets.end(); ++it) {
+                if (size_it == sizes.end()) {
+                    throw format_exception{"tile index does not fit the tile data"};
+                }
+                feature_offset += *it;
+                const uint32_t feature_size = *size_it++;
+                if (feature_offset > size || feature_size > size - feature_offset) {
+                    throw format_exception{"tile index does not fit the tile data"};
+                }
+                new_layer.m_feature_index.emplace_back(layer_data.data() + feature_offset, feature_size);
+            }
+            if (size_it != sizes.end()) {
+                throw format_exception{"tile index does not fit the tile data"};
+            }
+
+            uint32_t position = 0;
+            const char* id_data = ids_data.data();
+            const char* const id_end = id_data + ids_data.size();
+            for (auto it = id_positions.begin(); it != id_positions.end(); ++it) {
+                if (id_data == id_end) {
+                    throw format_exception{"tile index does not fit the tile data"};
+                }
+                position += *it;
+                if (position >= new_layer.m_feature_index.size()) {
+                    throw format_exception{"tile index does not fit the tile data"};
+                }
+                const uint64_t id = protozero::decode_varint(&id_data, id_end);
+                new_layer.m_features_by_id.emplace(id, new_layer.m_feature_index[position]);
+            }
+            if (id_data != id_end) {
+                throw format_exception{"tile index does not fit the tile data"};
+            }
+
+            new_layer.m_has_feature_index = true;
+            m_layers.push_back(std::move(new_layer));
+        }
+
+    }; // class tile_index
+
+} // namespace vtzero
+
+#endif // VTZERO_TILE_INDEX_HPP
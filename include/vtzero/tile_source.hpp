@@ -0,0 +1,112 @@
+#ifndef VTZERO_TILE_SOURCE_HPP
+#define VTZERO_TILE_SOURCE_HPP
+
+/*****************************************************************************
+
+vtzero - Tiny and fast vector tile decoder and encoder in C++.
+
+This file is from https://github.com/mapbox/vtzero where you can find more
+documentation.
+
+*****************************************************************************/
+
+/**
+ * @file tile_source.hpp
+ *
+ * @brief Contains the tile_source class.
+ */
+
+#include "types.hpp"
+#include "vector_tile.hpp"
+
+#include <string>
+#include <utility>
+
+namespace vtzero {
+
+    /**
+     * Is this data gzip-compressed? Checks for the gzip magic bytes at the
+     * start of the data.
+     */
+    inline bool is_gzip_compressed(const data_view data) noexcept {
+        return data.size() >= 2 &&
+               static_cast<unsigned char>(data.data()[0]) == 0x1FU &&
+               static_cast<unsigned char>(data.data()[1]) == 0x8BU;
+    }
+
+    /**
+     * Input abstraction turning possibly gzip-compressed tile data into
+     * vector_tile objects.
+     *
+     * vtzero itself has no compression dependency, so the inflation is
+     * done by a caller-provided function, typically a thin wrapper around
+     * zlib or libdeflate. Uncompressed data is handed to the vector_tile
+     * without being copied; compressed data is inflated into an internal
+     * buffer that is reused between calls, so a long-lived tile_source
+     * serves tile after tile without allocating in the steady state.
+     *
+     * @code
+     * vtzero::tile_source source;
+     * const auto tile = source.get_tile(data, [](vtzero::data_view input, std::string& output) {
+     *     my_gzip_inflate(input.data(), input.size(), output);
+     * });
+     * @endcode
+     *
+     * The returned vector_tile (and all layers and features from it) is
+     * only valid until the next call to get_tile() on the same tile_source
+     * and only as long as both the tile_source and the input data are
+     * alive.
+     */
+    class tile_source {
+
+        std::string m_buffer{};
+
+    public:
+
+        tile_source() = default;
+
+        /**
+         * Get a vector_tile for the specified data, inflating it first if
+         * it is gzip-compressed.
+         *
+         * @tparam TDecompress The type of the decompression function. It
+         *         must take a data_view with the compressed data and a
+         *         std::string& it appends the uncompressed data to.
+         * @param data The (possibly gzip-compressed) tile data.
+         * @param decompress The decompression function. Only called if the
+         *        data is compressed.
+         * @returns A vector_tile backed either by the input data (if it
+         *          was uncompressed) or by the internal buffer.
+         */
+        template <typename TDecompress>
+        vector_tile get_tile(const data_view data, TDecompress&& decompress) {
+            if (!is_gzip_compressed(data)) {
+                return vector_tile{data};
+            }
+
+            m_buffer.clear();
+            std::forward<TDecompress>(decompress)(data, m_buffer);
+            return vector_tile{m_buffer};
+        }
+
+        /**
+         * Get a vector_tile for the specified uncompressed data. This is
+         * always zero-copy.
+         *
+         * @param data The tile data.
+         * @returns A vector_tile backed by the input data.
+         * @throws format_exception if the data is gzip-compressed.
+         */
+        vector_tile get_tile(const data_view data) {
+            if (is_gzip_compressed(data)) {
+                throw format_exception{"tile data is gzip-compressed"};
+            }
+
+            return vector_tile{data};
+        }
+
+    }; // class tile_source
+
+} // namespace vtzero
+
+#endif // VTZERO_TILE_SOURCE_HPP
@@ -0,0 +1,489 @@
+#ifndef VTZERO_TRY_DECODE_HPP
+#define VTZERO_TRY_DECODE_HPP
+
+/*****************************************************************************
+
+vtzero - Tiny and fast vector tile decoder and encoder in C++.
+
+This file is from https://github.com/mapbox/vtzero where you can find more
+documentation.
+
+*****************************************************************************/
+
+/**
+ * @file try_decode.hpp
+ *
+ * @brief Contains the try_decode_geometry() functions and the
+ *        geometry_error struct.
+ *
+ * This is an exception-free alternative to the decode_geometry()
+ * functions in geometry.hpp. Malformed geometries are reported through
+ * a returned error code plus the byte offset where the problem was
+ * detected instead of a thrown geometry_exception, so rejecting dirty
+ * third-party tiles is a branch, not a throw, and the functions can be
+ * used from code compiled with -fno-exceptions. vtzero itself throws
+ * nothing here; if the geometry handler doesn't throw either, the
+ * whole decode is exception-free.
+ */
+
+#include "geometry.hpp"
+#include "types.hpp"
+
+#include <protozero/varint.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+namespace vtzero {
+
+    /**
+     * The errors that can be detected while decoding a geometry. The
+     * values correspond to the geometry_exception messages thrown by the
+     * decode_geometry() functions.
+     */
+    enum class geometry_error_code : uint32_t {
+
+        /// The geometry is okay.
+        ok = 0,
+
+        /// The data ends in the middle of a varint.
+        truncated = 1,
+
+        /// The geometry has an unknown type.
+        unknown_geometry_type = 2,
+
+        /// The data ended where the spec requires another command.
+        missing_command = 3,
+
+        /// A different command than the spec requires was found.
+        unexpected_command = 4,
+
+        /// A command count is invalid (zero, not 1, or too large).
+        invalid_command_count = 5,
+
+        /// The data ends in the middle of the points of a command.
+        too_few_points = 6,
+
+        /// There is additional data after the end of the geometry.
+        extra_data = 7
+
+    }; // enum class geometry_error_code
+
+    /**
+     * A human-readable message for an error code. Useful for logging.
+     */
+    inline const char* geometry_error_message(const geometry_error_code code) noexcept {
+        switch (code) {
+            case geometry_error_code::ok:
+                return "okay";
+            case geometry_error_code::truncated:
+                return "data ends in the middle of a varint";
+            case geometry_error_code::unknown_geometry_type:
+                return "unknown geometry type";
+            case geometry_error_code::missing_command:
+                return "expected another command";
+            case geometry_error_code::unexpected_command:
+                return "unexpected command";
+            case geometry_error_code::invalid_command_count:
+                return "invalid command count";
+            case geometry_error_code::too_few_points:
+                return "too few points in geometry";
+            case geometry_error_code::extra_data:
+                return "additional data after end of geometry";
+        }
+        return "unknown error";
+    }
+
+    /**
+     * The result of the try_decode_geometry() functions: an error code
+     * plus the position where the error was detected.
+     */
+    struct geometry_error {
+
+        /// The error code, geometry_error_code::ok if the geometry is okay.
+        geometry_error_code code = geometry_error_code::ok;
+
+        /// The byte offset into the geometry data where the error was
+        /// detected. Always 0 when the geometry is okay.
+        std::size_t offset = 0;
+
+        /// Construct an "okay" result.
+        geometry_error() noexcept = default;
+
+        /// Construct a result with the specified code and offset.
+        geometry_error(const geometry_error_code code_, const std::size_t offset_) noexcept :
+            code(code_),
+            offset(offset_) {
+        }
+
+        /// Is the geometry okay?
+        bool ok() const noexcept {
+            return code == geometry_error_code::ok;
+        }
+
+        /// A human-readable message for this error. Useful for logging.
+        const char* message() const noexcept {
+            return geometry_error_message(code);
+        }
+
+    }; // struct geometry_error
+
+    namespace detail {
+
+        /**
+         * Exception-free counterpart of the geometry_decoder. Works
+         * directly on the raw geometry bytes and reports malformed data
+         * through geometry_error values instead of throwing. The grammar
+         * and validation rules are the same as in the checked throwing
+         * decoder.
+         */
+        class nothrow_geometry_decoder {
+
+            const char* m_begin;
+            const char* m_data;
+            const char* m_end;
+
+            point m_cursor{0, 0};
+            uint32_t m_count = 0;
+            uint32_t m_max_count;
+
+            enum class step {
+                okay  = 0, // got the expected command
+                done  = 1, // regular end of the data
+                error = 2  // malformed data, error is set
+            };
+
+            geometry_error error(const geometry_error_code code) const noexcept {
+                return {code, static_cast<std::size_t>(m_data - m_begin)};
+            }
+
+            // Decode one varint without throwing. Accepts the same
+            // encodings as the protozero varint decoder, truncating
+            // values to 32 bit like the packed uint32 iterators do.
+            bool next_varint(uint32_t& value) noexcept {
+                uint64_t v = 0;
+                for (unsigned int shift = 0; shift < 70 && m_data != m_end; shift += 7) {
+                    const auto byte = static_cast<uint64_t>(static_cast<uint8_t>(*m_data++));
+                    v |= (byte & 0x7FU) << shift;
+                    if ((byte & 0x80U) == 0) {
+                        value = static_cast<uint32_t>(v);
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            step next_command(const CommandId expected_command_id, geometry_error& err) noexcept {
+                if (m_data == m_end) {
+                    return step::done;
+                }
+
+                uint32_t command = 0;
+                if (!next_varint(command)) {
+                    err = error(geometry_error_code::truncated);
+                    return step::error;
+                }
+
+                if (get_command_id(command) != static_cast<uint32_t>(expected_command_id)) {
+                    err = error(geometry_error_code::unexpected_command);
+                    return step::error;
+                }
+
+                if (expected_command_id == CommandId::CLOSE_PATH) {
+                    // spec 4.3.3.3 "A ClosePath command MUST have a command count of 1"
+                    if (get_command_count(command) != 1) {
+                        err = error(geometry_error_code::invalid_command_count);
+                        return step::error;
+                    }
+                } else {
+                    m_count = get_command_count(command);
+                    if (m_count > m_max_count) {
+                        err = error(geometry_error_code::invalid_command_count);
+                        return step::error;
+                    }
+                }
+
+                return step::okay;
+            }
+
+            bool next_point(point& p, geometry_error& err) noexcept {
+                uint32_t x = 0;
+                uint32_t y = 0;
+                if (!next_varint(x) || !next_varint(y)) {
+                    err = error(geometry_error_code::too_few_points);
+                    return false;
+                }
+
+                // The same truncating casts as in the throwing decoder,
+                // see the comments there.
+                m_cursor.x = static_cast<int32_t>(m_cursor.x + static_cast<int64_t>(protozero::decode_zigzag32(x)));
+                m_cursor.y = static_cast<int32_t>(m_cursor.y + static_cast<int64_t>(protozero::decode_zigzag32(y)));
+
+                p = m_cursor;
+                --m_count;
+                return true;
+            }
+
+        public:
+
+            explicit nothrow_geometry_decoder(const data_view data) noexcept :
+                m_begin(data.data()),
+                m_data(data.data()),
+                m_end(data.data() + data.size()),
+                m_max_count(static_cast<uint32_t>(data.size() / 2)) {
+            }
+
+            template <typename TGeomHandler>
+            geometry_error decode_point(TGeomHandler&& geom_handler) {
+                geometry_error err{};
+
+                // spec 4.3.4.2 "MUST consist of a single MoveTo command"
+                const step s = next_command(CommandId::MOVE_TO, err);
+                if (s == step::error) {
+                    return err;
+                }
+                if (s == step::done) {
+                    return error(geometry_error_code::missing_command);
+                }
+
+                // spec 4.3.4.2 "command count greater than 0"
+                if (m_count == 0) {
+                    return error(geometry_error_code::invalid_command_count);
+                }
+
+                geom_handler.points_begin(m_count);
+                point p{};
+                while (m_count > 0) {
+                    if (!next_point(p, err)) {
+                        return err;
+                    }
+                    geom_handler.points_point(p);
+                }
+
+                // spec 4.3.4.2 "MUST consist of of a single ... command"
+                if (m_data != m_end) {
+                    return error(geometry_error_code::extra_data);
+                }
+
+                geom_handler.points_end();
+                return {};
+            }
+
+            template <typename TGeomHandler>
+            geometry_error decode_linestring(TGeomHandler&& geom_handler) {
+                geometry_error err{};
+
+                for (;;) {
+                    // spec 4.3.4.3 "1. A MoveTo command"
+                    step s = next_command(CommandId::MOVE_TO, err);
+                    if (s == step::error) {
+                        return err;
+                    }
+                    if (s == step::done) {
+                        return {};
+                    }
+
+                    // spec 4.3.4.3 "with a command count of 1"
+                    if (m_count != 1) {
+                        return error(geometry_error_code::invalid_command_count);
+                    }
+
+                    point first_point{};
+                    if (!next_point(first_point, err)) {
+                        return err;
+                    }
+
+                    // spec 4.3.4.3 "2. A LineTo command"
+                    s = next_command(CommandId::LINE_TO, err);
+                    if (s == step::error) {
+                        return err;
+                    }
+                    if (s == step::done) {
+                        return error(geometry_error_code::missing_command);
+                    }
+
+                    // spec 4.3.4.3 "with a command count greater than 0"
+                    if (m_count == 0) {
+                        return error(geometry_error_code::invalid_command_count);
+                    }
+
+                    geom_handler.linestring_begin(m_count + 1);
+
+                    geom_handler.linestring_point(first_point);
+                    point p{};
+                    while (m_count > 0) {
+                        if (!next_point(p, err)) {
+                            return err;
+                        }
+                        geom_handler.linestring_point(p);
+                    }
+
+                    geom_handler.linestring_end();
+                }
+            }
+
+            template <typename TGeomHandler>
+            geometry_error decode_polygon(TGeomHandler&& geom_handler) {
+                geometry_error err{};
+
+                for (;;) {
+                    // spec 4.3.4.4 "1. A MoveTo command"
+                    step s = next_command(CommandId::MOVE_TO, err);
+                    if (s == step::error) {
+                        return err;
+                    }
+                    if (s == step::done) {
+                        return {};
+                    }
+
+                    // spec 4.3.4.4 "with a command count of 1"
+                    if (m_count != 1) {
+                        return error(geometry_error_code::invalid_command_count);
+                    }
+
+                    int64_t sum = 0;
+                    point start_point{};
+                    if (!next_point(start_point, err)) {
+                        return err;
+                    }
+                    point last_point = start_point;
+
+                    // spec 4.3.4.4 "2. A LineTo command"
+                    s = next_command(CommandId::LINE_TO, err);
+                    if (s == step::error) {
+                        return err;
+                    }
+                    if (s == step::done) {
+                        return error(geometry_error_code::missing_command);
+                    }
+
+                    geom_handler.ring_begin(m_count + 2);
+
+                    geom_handler.ring_point(start_point);
+
+                    point p{};
+                    while (m_count > 0) {
+                        if (!next_point(p, err)) {
+                            return err;
+                        }
+                        sum += detail::det(last_point, p);
+                        last_point = p;
+                        geom_handler.ring_point(p);
+                    }
+
+                    // spec 4.3.4.4 "3. A ClosePath command"
+                    s = next_command(CommandId::CLOSE_PATH, err);
+                    if (s == step::error) {
+                        return err;
+                    }
+                    if (s == step::done) {
+                        return error(geometry_error_code::missing_command);
+                    }
+
+                    sum += detail::det(last_point, start_point);
+
+                    geom_handler.ring_point(start_point);
+
+                    detail::ring_end_caller<typename std::remove_reference<TGeomHandler>::type>::call(
+                        geom_handler,
+                        sum > 0 ? ring_type::outer :
+                        sum < 0 ? ring_type::inner : ring_type::invalid,
+                        sum);
+                }
+            }
+
+        }; // class nothrow_geometry_decoder
+
+    } // namespace detail
+
+    /**
+     * Decode a point geometry without throwing on malformed data.
+     *
+     * Unlike decode_point_geometry() this doesn't return the result of
+     * the handler, read it from the handler object after the call.
+     *
+     * @tparam TGeomHandler Handler class. See tutorial for details.
+     * @param geometry The geometry as returned by feature.geometry().
+     * @param geom_handler An object of TGeomHandler.
+     * @returns A geometry_error, check with ok().
+     * @pre Geometry must be a point geometry.
+     */
+    template <typename TGeomHandler>
+    geometry_error try_decode_point_geometry(const geometry& geometry, TGeomHandler&& geom_handler) {
+        vtzero_assert(geometry.type() == GeomType::POINT);
+        detail::nothrow_geometry_decoder decoder{geometry.data()};
+        return decoder.decode_point(std::forward<TGeomHandler>(geom_handler));
+    }
+
+    /**
+     * Decode a linestring geometry without throwing on malformed data.
+     *
+     * Unlike decode_linestring_geometry() this doesn't return the result
+     * of the handler, read it from the handler object after the call.
+     *
+     * @tparam TGeomHandler Handler class. See tutorial for details.
+     * @param geometry The geometry as returned by feature.geometry().
+     * @param geom_handler An object of TGeomHandler.
+     * @returns A geometry_error, check with ok().
+     * @pre Geometry must be a linestring geometry.
+     */
+    template <typename TGeomHandler>
+    geometry_error try_decode_linestring_geometry(const geometry& geometry, TGeomHandler&& geom_handler) {
+        vtzero_assert(geometry.type() == GeomType::LINESTRING);
+        detail::nothrow_geometry_decoder decoder{geometry.data()};
+        return decoder.decode_linestring(std::forward<TGeomHandler>(geom_handler));
+    }
+
+    /**
+     * Decode a polygon geometry without throwing on malformed data.
+     *
+     * Unlike decode_polygon_geometry() this doesn't return the result of
+     * the handler, read it from the handler object after the call. The
+     * optional int64_t ring area parameter of ring_end() is supported
+     * the same way.
+     *
+     * @tparam TGeomHandler Handler class. See tutorial for details.
+     * @param geometry The geometry as returned by feature.geometry().
+     * @param geom_handler An object of TGeomHandler.
+     * @returns A geometry_error, check with ok().
+     * @pre Geometry must be a polygon geometry.
+     */
+    template <typename TGeomHandler>
+    geometry_error try_decode_polygon_geometry(const geometry& geometry, TGeomHandler&& geom_handler) {
+        vtzero_assert(geometry.type() == GeomType::POLYGON);
+        detail::nothrow_geometry_decoder decoder{geometry.data()};
+        return decoder.decode_polygon(std::forward<TGeomHandler>(geom_handler));
+    }
+
+    /**
+     * Decode a geometry without throwing on malformed data.
+     *
+     * Unlike decode_geometry() this doesn't return the result of the
+     * handler, read it from the handler object after the call.
+     *
+     * @tparam TGeomHandler Handler class. See tutorial for details.
+     * @param geometry The geometry as returned by feature.geometry().
+     * @param geom_handler An object of TGeomHandler.
+     * @returns A geometry_error, check with ok().
+     */
+    template <typename TGeomHandler>
+    geometry_error try_decode_geometry(const geometry& geometry, TGeomHandler&& geom_handler) {
+        detail::nothrow_geometry_decoder decoder{geometry.data()};
+        switch (geometry.type()) {
+            case GeomType::POINT:
+                return decoder.decode_point(std::forward<TGeomHandler>(geom_handler));
+            case GeomType::LINESTRING:
+                return decoder.decode_linestring(std::forward<TGeomHandler>(geom_handler));
+            case GeomType::POLYGON:
+                return decoder.decode_polygon(std::forward<TGeomHandler>(geom_handler));
+            default:
+                break;
+        }
+        return {geometry_error_code::unknown_geometry_type, 0};
+    }
+
+} // namespace vtzero
+
+#endif // VTZERO_TRY_DECODE_HPP
@@ -14,6 +14,8 @@ documentation.
 
 #include <array>
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
 #include <limits>
 
 // @cond internal
@@ -111,6 +113,16 @@ namespace vtzero {
 
         using pbf_value = property_value_type;
 
+        /// FNV-1a hash over the bytes of the data.
+        inline std::size_t byte_hash(const data_view view) noexcept {
+            uint64_t hash = 0xcbf29ce484222325ULL;
+            for (std::size_t i = 0; i < view.size(); ++i) {
+                hash ^= static_cast<uint64_t>(static_cast<unsigned char>(view.data()[i]));
+                hash *= 0x100000001b3ULL;
+            }
+            return static_cast<std::size_t>(hash);
+        }
+
     } // namespace detail
 
     /// property value type holding a reference to a string
@@ -0,0 +1,273 @@
+#ifndef VTZERO_VALIDATE_HPP
+#define VTZERO_VALIDATE_HPP
+
+/*****************************************************************************
+
+vtzero - Tiny and fast vector tile decoder and encoder in C++.
+
+This file is from https://github.com/mapbox/vtzero where you can find more
+documentation.
+
+*****************************************************************************/
+
+/**
+ * @file validate.hpp
+ *
+ * @brief Contains the validate() function and the validation_result class.
+ */
+
+#include "geometry.hpp"
+#include "vector_tile.hpp"
+
+#include <cstdint>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace vtzero {
+
+    /**
+     * The result of a validate() run: the formatted warning/error messages
+     * and the overall severity.
+     *
+     * A validation_result can (and for batch jobs should) be reused for
+     * many tiles, call clear() between tiles.
+     */
+    class validation_result {
+
+        std::vector<std::string> m_messages{};
+        int m_severity = 0;
+
+    public:
+
+        /// Add a warning message.
+        void add_warning(std::string message) {
+            m_messages.push_back(std::move(message));
+            if (m_severity < 1) {
+                m_severity = 1;
+            }
+        }
+
+        /// Add an error message.
+        void add_error(std::string message) {
+            m_messages.push_back(std::move(message));
+            if (m_severity < 2) {
+                m_severity = 2;
+            }
+        }
+
+        /// Add a fatal error message.
+        void add_fatal_error(std::string message) {
+            m_messages.push_back(std::move(message));
+            if (m_severity < 3) {
+                m_severity = 3;
+            }
+        }
+
+        /// Is the tile valid, ie were there no messages at all?
+        bool ok() const noexcept {
+            return m_severity == 0;
+        }
+
+        /**
+         * The overall severity: 0 for a valid tile, 1 if there were
+         * warnings, 2 if there were errors, and 3 if there was a fatal
+         * error (the tile could not be decoded at all). Suitable as a
+         * process return code.
+         */
+        int return_code() const noexcept {
+            return m_severity;
+        }
+
+        /// The formatted messages in the order they were generated.
+        const std::vector<std::string>& messages() const noexcept {
+            return m_messages;
+        }
+
+        /// Clear the result so it can be reused for the next tile.
+        void clear() {
+            m_messages.clear();
+            m_severity = 0;
+        }
+
+    }; // class validation_result
+
+    namespace detail {
+
+        /// Geometry handler used by validate(). Not for public use.
+        class validate_geom_handler {
+
+            validation_result* m_result;
+            point m_prev_point{};
+            int m_layer_num;
+            int m_feature_num;
+            int64_t m_extent;
+            bool m_is_first_point = false;
+            int m_count = 0;
+
+            std::string context() const {
+                return " in layer " + std::to_string(m_layer_num) +
+                       " in feature " + std::to_string(m_feature_num) +
+                       " in geometry " + std::to_string(m_count) + ": ";
+            }
+
+            void add_error(const char* message) const {
+                m_result->add_error("Error" + context() + message);
+            }
+
+            void add_warning(const char* message) const {
+                m_result->add_warning("Warning" + context() + message);
+            }
+
+            void check_point_location(const point p) const {
+                if (p.x < -m_extent ||
+                    p.y < -m_extent ||
+                    p.x > 2 * m_extent ||
+                    p.y > 2 * m_extent) {
+                    add_warning("point waaaay beyond the extent");
+                }
+            }
+
+        public:
+
+            validate_geom_handler(validation_result& result, uint32_t extent, int layer_num, int feature_num) :
+                m_result(&result),
+                m_layer_num(layer_num),
+                m_feature_num(feature_num),
+                m_extent(static_cast<int64_t>(extent)) {
+            }
+
+            // ----------------------------------------------------------
+
+            void points_begin(const uint32_t /*count*/) const {
+            }
+
+            void points_point(const point p) const {
+                check_point_location(p);
+            }
+
+            void points_end() const {
+            }
+
+            // ----------------------------------------------------------
+
+            void linestring_begin(const uint32_t count) {
+                if (count < 2) {
+                    add_error("Not enough points in linestring");
+                }
+                m_is_first_point = true;
+            }
+
+            void linestring_point(const point p) {
+                if (m_is_first_point) {
+                    m_is_first_point = false;
+                } else if (p == m_prev_point) {
+                    add_error("Duplicate point in linestring");
+                }
+                m_prev_point = p;
+
+                check_point_location(p);
+            }
+
+            void linestring_end() {
+                ++m_count;
+            }
+
+            // ----------------------------------------------------------
+
+            void ring_begin(const uint32_t count) {
+                if (count < 4) {
+                    add_error("Not enough points in ring");
+                }
+                m_is_first_point = true;
+            }
+
+            void ring_point(const point p) {
+                if (m_is_first_point) {
+                    m_is_first_point = false;
+                } else if (p == m_prev_point) {
+                    add_error("Duplicate point in ring");
+                }
+                m_prev_point = p;
+
+                check_point_location(p);
+            }
+
+            void ring_end(const ring_type rt) {
+                if (rt == ring_type::invalid) {
+                    add_error("Invalid ring with area 0");
+                }
+                if (m_count == 0 && rt != ring_type::outer) {
+                    add_error("First ring isn't an outer ring");
+                }
+                ++m_count;
+            }
+
+        }; // class validate_geom_handler
+
+    } // namespace detail
+
+    /**
+     * Validate a vector tile beyond what the normal decoding checks: layer
+     * names must be non-empty and unique, layers and geometries must be
+     * non-empty, linestrings and rings must have enough points and no
+     * duplicates, rings must have non-zero area and start with an outer
+     * ring, and points shouldn't be absurdly far outside the extent.
+     * Decoding failures of any kind are reported as fatal errors instead
+     * of being thrown.
+     *
+     * Warnings, errors, and fatal errors are added to the result as
+     * formatted messages; the result's previous contents are kept, clear
+     * it before the call if you don't want that.
+     *
+     * @param tile_data The encoded vector tile.
+     * @param result The validation result messages are added to.
+     */
+    inline void validate(const data_view tile_data, validation_result& result) {
+        std::set<std::string> layer_names;
+
+        vector_tile tile{tile_data};
+
+        int layer_num = 0;
+        int feature_num = -1;
+        try {
+            while (auto layer = tile.next_layer()) {
+                if (layer.name().empty()) {
+                    result.add_error("Error in layer " + std::to_string(layer_num) + ": name is empty (spec 4.1)");
+                }
+
+                std::string name(layer.name());
+                if (layer_names.count(name) > 0) {
+                    result.add_error("Error in layer " + std::to_string(layer_num) + ": name is duplicate of previous layer ('" + name + "') (spec 4.1)");
+                }
+
+                layer_names.insert(std::move(name));
+
+                feature_num = 0;
+                while (auto feature = layer.next_feature()) {
+                    detail::validate_geom_handler handler{result, layer.extent(), layer_num, feature_num};
+                    decode_geometry(feature.geometry(), handler);
+                    ++feature_num;
+                }
+                if (feature_num == 0) {
+                    result.add_warning("Warning: No features in layer " + std::to_string(layer_num) + " (spec 4.1)");
+                }
+                feature_num = -1;
+                ++layer_num;
+            }
+            if (layer_num == 0) {
+                result.add_warning("Warning: No layers in vector tile (spec 4.1)");
+            }
+        } catch (const std::exception& e) {
+            std::string message{"Fatal error in layer " + std::to_string(layer_num)};
+            if (feature_num >= 0) {
+                message += " in feature " + std::to_string(feature_num);
+            }
+            result.add_fatal_error(message + ": " + e.what());
+        }
+    }
+
+} // namespace vtzero
+
+#endif // VTZERO_VALIDATE_HPP
@@ -26,9 +26,123 @@ documentation.
 #include <cstring>
 #include <iterator>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace vtzero {
 
+    /**
+     * Forward iterator over the layers of a vector tile. Usually not
+     * created directly, use vector_tile::layers().
+     *
+     * The iterator owns its position in the tile data and a copy of the
+     * current layer, so copies of an iterator can be advanced
+     * independently and nothing is allocated.
+     */
+    class layer_iterator {
+
+        protozero::pbf_message<detail::pbf_tile> m_reader{};
+        layer m_layer{};
+
+        void advance() {
+            if (m_reader.next(detail::pbf_tile::layers,
+                              protozero::pbf_wire_type::length_delimited)) {
+                m_layer = layer{m_reader.get_view()};
+            } else {
+                m_layer = layer{};
+            }
+        }
+
+    public:
+
+        /// @name Iterator traits
+        ///@{
+        using iterator_category = std::forward_iterator_tag; ///< iterator category
+        using value_type        = layer;                     ///< value type
+        using difference_type   = std::ptrdiff_t;            ///< difference type
+        using pointer           = const layer*;              ///< pointer type
+        using reference         = const layer&;              ///< reference type
+        ///@}
+
+        /// Construct the past-the-end iterator.
+        layer_iterator() = default;
+
+        /**
+         * Construct an iterator pointing to the first layer in the
+         * specified tile data.
+         *
+         * @throws format_exception if the tile data is ill-formed.
+         * @throws any protozero exception if the protobuf encoding is
+         *         invalid.
+         */
+        explicit layer_iterator(const data_view tile_data) :
+            m_reader(tile_data) {
+            advance();
+        }
+
+        /// Get the current layer.
+        reference operator*() const noexcept {
+            return m_layer;
+        }
+
+        /// Access the current layer.
+        pointer operator->() const noexcept {
+            return &m_layer;
+        }
+
+        /// Advance to the next layer.
+        layer_iterator& operator++() {
+            advance();
+            return *this;
+        }
+
+        /// Advance to the next layer (postfix).
+        layer_iterator operator++(int) {
+            const layer_iterator tmp{*this};
+            ++(*this);
+            return tmp;
+        }
+
+        /// Iterators are equal if they point to the same layer or are
+        /// both at the end.
+        friend bool operator==(const layer_iterator& lhs, const layer_iterator& rhs) noexcept {
+            return lhs.m_layer.data().data() == rhs.m_layer.data().data();
+        }
+
+        /// Iterators are not equal if operator==() returns false.
+        friend bool operator!=(const layer_iterator& lhs, const layer_iterator& rhs) noexcept {
+            return !(lhs == rhs);
+        }
+
+    }; // class layer_iterator
+
+    /**
+     * A forward-iterable range over the layers of a vector tile as
+     * returned by vector_tile::layers().
+     */
+    class layer_range {
+
+        data_view m_data{};
+
+    public:
+
+        /// Construct a range over the layers in the specified tile data.
+        explicit layer_range(const data_view tile_data) noexcept :
+            m_data(tile_data) {
+        }
+
+        /// Iterator to the first layer.
+        layer_iterator begin() const {
+            return layer_iterator{m_data};
+        }
+
+        /// Past-the-end iterator.
+        layer_iterator end() const noexcept {
+            return {};
+        }
+
+    }; // class layer_range
+
     /**
      * A vector tile is basically nothing more than an ordered collection
      * of named layers. For the most efficient way to access the layers,
@@ -51,12 +165,20 @@ namespace vtzero {
      * @code
      *   tile.get_layer_by_name("foobar");
      * @endcode
+     *
+     * If you call get_layer() or get_layer_by_name() repeatedly on the same
+     * tile, call build_layer_index() once first. Lookups then use the index
+     * instead of re-scanning the tile data on every call.
      */
     class vector_tile {
 
         data_view m_data;
         protozero::pbf_message<detail::pbf_tile> m_tile_reader;
 
+        mutable std::vector<data_view> m_layer_index;
+        mutable std::unordered_map<std::string, data_view> m_layers_by_name;
+        mutable bool m_has_layer_index = false;
+
     public:
 
         /**
@@ -89,6 +211,13 @@ namespace vtzero {
             m_tile_reader(m_data) {
         }
 
+        /**
+         * Get a reference to the raw data this tile was created from.
+         */
+        data_view data() const noexcept {
+            return m_data;
+        }
+
         /**
          * Is this vector tile empty?
          *
@@ -148,6 +277,23 @@ namespace vtzero {
             m_tile_reader = protozero::pbf_message<detail::pbf_tile>{m_data};
         }
 
+        /**
+         * Get a forward-iterable range over the layers of this tile.
+         * Unlike next_layer() this has no cursor state in the tile
+         * object: every call to begin() starts from the first layer and
+         * independent iterators can be in flight at the same time, so
+         * the range can be fed into standard algorithms.
+         *
+         * @code
+         *   for (const auto& layer : tile.layers()) {
+         *     ...
+         *   }
+         * @endcode
+         */
+        layer_range layers() const noexcept {
+            return layer_range{m_data};
+        }
+
         /**
          * Call a function for each layer in this tile.
          *
@@ -172,16 +318,69 @@ namespace vtzero {
         }
 
         /**
-         * Returns the layer with the specified zero-based index.
+         * Build an index into the layers of this tile. This needs one scan
+         * over the tile data. Afterwards get_layer() works in constant time
+         * and get_layer_by_name() in amortized constant time instead of
+         * re-scanning the tile data on every call.
+         *
+         * Calling this a second time does nothing.
          *
          * Complexity: Linear in the number of layers.
          *
+         * @throws format_exception if the tile data is ill-formed.
+         * @throws any protozero exception if the protobuf encoding is invalid.
+         */
+        void build_layer_index() const {
+            if (m_has_layer_index) {
+                return;
+            }
+
+            protozero::pbf_message<detail::pbf_tile> tile_reader{m_data};
+            while (tile_reader.next(detail::pbf_tile::layers,
+                                    protozero::pbf_wire_type::length_delimited)) {
+                const auto layer_data = tile_reader.get_view();
+                m_layer_index.push_back(layer_data);
+                protozero::pbf_message<detail::pbf_layer> layer_reader{layer_data};
+                if (layer_reader.next(detail::pbf_layer::name,
+                                      protozero::pbf_wire_type::length_delimited)) {
+                    m_layers_by_name.emplace(std::string(layer_reader.get_view()), layer_data);
+                } else {
+                    // 4.1 "A layer MUST contain a name field."
+                    throw format_exception{"missing name in layer (spec 4.1)"};
+                }
+            }
+
+            m_has_layer_index = true;
+        }
+
+        /**
+         * Was the layer index built for this tile?
+         *
+         * Complexity: Constant.
+         */
+        bool has_layer_index() const noexcept {
+            return m_has_layer_index;
+        }
+
+        /**
+         * Returns the layer with the specified zero-based index.
+         *
+         * Complexity: Constant if build_layer_index() was called before,
+         *             linear in the number of layers otherwise.
+         *
          * @returns The specified layer or the invalid layer if index is
          *          larger than the number of layers.
          * @throws format_exception if the tile data is ill-formed.
          * @throws any protozero exception if the protobuf encoding is invalid.
          */
         layer get_layer(std::size_t index) const {
+            if (m_has_layer_index) {
+                if (index >= m_layer_index.size()) {
+                    return layer{};
+                }
+                return layer{m_layer_index[index]};
+            }
+
             protozero::pbf_message<detail::pbf_tile> tile_reader{m_data};
 
             while (tile_reader.next(detail::pbf_tile::layers,
@@ -199,7 +398,8 @@ namespace vtzero {
         /**
          * Returns the layer with the specified name.
          *
-         * Complexity: Linear in the number of layers.
+         * Complexity: Amortized constant if build_layer_index() was called
+         *             before, linear in the number of layers otherwise.
          *
          * If there are several layers with the same name (which is against
          * the spec 4.1 "A Vector Tile MUST NOT contain two or more layers
@@ -212,6 +412,14 @@ namespace vtzero {
          * @throws any protozero exception if the protobuf encoding is invalid.
          */
         layer get_layer_by_name(const data_view name) const {
+            if (m_has_layer_index) {
+                const auto it = m_layers_by_name.find(std::string(name));
+                if (it == m_layers_by_name.end()) {
+                    return layer{};
+                }
+                return layer{it->second};
+            }
+
             protozero::pbf_message<detail::pbf_tile> tile_reader{m_data};
 
             while (tile_reader.next(detail::pbf_tile::layers,
@@ -235,7 +443,8 @@ namespace vtzero {
         /**
          * Returns the layer with the specified name.
          *
-         * Complexity: Linear in the number of layers.
+         * Complexity: Amortized constant if build_layer_index() was called
+         *             before, linear in the number of layers otherwise.
          *
          * If there are several layers with the same name (which is against
          * the spec 4.1 "A Vector Tile MUST NOT contain two or more layers
@@ -254,7 +463,8 @@ namespace vtzero {
         /**
          * Returns the layer with the specified name.
          *
-         * Complexity: Linear in the number of layers.
+         * Complexity: Amortized constant if build_layer_index() was called
+         *             before, linear in the number of layers otherwise.
          *
          * If there are several layers with the same name (which is against
          * the spec 4.1 "A Vector Tile MUST NOT contain two or more layers
@@ -9,8 +9,10 @@
 #include <protozero/buffer_fixed.hpp>
 #include <protozero/buffer_vector.hpp>
 
+#include <array>
 #include <cstdint>
 #include <string>
+#include <thread>
 #include <type_traits>
 
 template <typename T>
@@ -131,6 +133,156 @@ TEST_CASE("Create layer and add keys/values") {
     REQUIRE(vi4 == vi7);
 }
 
+TEST_CASE("Reserving capacity in the layer doesn't change the result") {
+    std::string data_with_reserve;
+    std::string data_without_reserve;
+
+    for (int use_reserve = 0; use_reserve < 2; ++use_reserve) {
+        vtzero::tile_builder tbuilder;
+        vtzero::layer_builder lbuilder{tbuilder, "test"};
+        if (use_reserve > 0) {
+            lbuilder.reserve(1024, 256, 256);
+        }
+
+        vtzero::point_feature_builder fbuilder{lbuilder};
+        fbuilder.set_id(17);
+        fbuilder.add_point(10, 20);
+        fbuilder.add_property("key", "value");
+        fbuilder.commit();
+
+        tbuilder.serialize(use_reserve > 0 ? data_with_reserve : data_without_reserve);
+    }
+
+    REQUIRE_FALSE(data_with_reserve.empty());
+    REQUIRE(data_with_reserve == data_without_reserve);
+}
+
+TEST_CASE("Clear tile builder and reuse it for the next tile") {
+    vtzero::tile_builder tbuilder;
+
+    const auto build_tile = [&tbuilder](const uint64_t id, const int32_t x) {
+        vtzero::layer_builder lbuilder{tbuilder, "test"};
+        vtzero::point_feature_builder fbuilder{lbuilder};
+        fbuilder.set_id(id);
+        fbuilder.add_point(x, 20);
+        fbuilder.add_property("key", "value");
+        fbuilder.commit();
+        const std::string data = tbuilder.serialize();
+        tbuilder.clear();
+        return data;
+    };
+
+    const std::string first = build_tile(17, 10);
+    const std::string second = build_tile(35, 99);
+
+    REQUIRE_FALSE(first == second);
+
+    // the reused builder must create the same data a new builder creates
+    vtzero::tile_builder fresh_builder;
+    {
+        vtzero::layer_builder lbuilder{fresh_builder, "test"};
+        vtzero::point_feature_builder fbuilder{lbuilder};
+        fbuilder.set_id(35);
+        fbuilder.add_point(99, 20);
+        fbuilder.add_property("key", "value");
+        fbuilder.commit();
+    }
+    REQUIRE(second == fresh_builder.serialize());
+
+    vtzero::vector_tile tile{second};
+    auto layer = tile.next_layer();
+    REQUIRE(layer.name() == "test");
+    REQUIRE(layer.num_features() == 1);
+    REQUIRE(layer.next_feature().id() == 35);
+}
+
+TEST_CASE("serialized_size() returns the exact size of the serialized tile") {
+    const auto buffer = load_test_tile();
+    vtzero::tile_builder tbuilder;
+
+    SECTION("empty builder") {
+        REQUIRE(tbuilder.serialized_size() == 0);
+    }
+
+    SECTION("existing layers") {
+        vtzero::vector_tile tile{buffer};
+        while (auto layer = tile.next_layer()) {
+            tbuilder.add_existing_layer(layer);
+        }
+    }
+
+    SECTION("layer built from scratch") {
+        vtzero::layer_builder lbuilder{tbuilder, "test"};
+        vtzero::point_feature_builder fbuilder{lbuilder};
+        fbuilder.add_point(10, 20);
+        fbuilder.add_property("key", "value");
+        fbuilder.commit();
+    }
+
+    SECTION("empty layers are not serialized") {
+        vtzero::layer_builder lbuilder{tbuilder, "test"};
+        REQUIRE(tbuilder.serialized_size() == 0);
+    }
+
+    const std::string data = tbuilder.serialize();
+    REQUIRE(tbuilder.serialized_size() == data.size());
+
+    // the size is exact, so serializing into a fixed-size buffer of
+    // exactly that size must work
+    std::vector<char> fixed_buffer(data.size());
+    protozero::fixed_size_buffer_adaptor adaptor{fixed_buffer.data(), fixed_buffer.size()};
+    tbuilder.serialize(adaptor);
+    REQUIRE(adaptor.size() == data.size());
+}
+
+TEST_CASE("serialize_segments() creates the same tile without copying layer bodies") {
+    const auto buffer = load_test_tile();
+    vtzero::vector_tile tile{buffer};
+
+    vtzero::tile_builder tbuilder;
+
+    // one layer passed through from the existing tile...
+    const auto existing_layer = tile.next_layer();
+    tbuilder.add_existing_layer(existing_layer);
+
+    // ...and one layer built from scratch
+    vtzero::layer_builder lbuilder{tbuilder, "test"};
+    vtzero::point_feature_builder fbuilder{lbuilder};
+    fbuilder.add_point(10, 20);
+    fbuilder.add_property("key", "value");
+    fbuilder.commit();
+
+    const auto segments = tbuilder.serialize_segments();
+    REQUIRE(segments.size() == tbuilder.serialized_size());
+
+    std::string concatenated;
+    bool found_existing_layer_body = false;
+    for (const auto segment : segments.segments()) {
+        concatenated.append(segment.data(), segment.size());
+        // the body of the existing layer is referenced, not copied
+        if (segment.data() == existing_layer.data().data()) {
+            found_existing_layer_body = true;
+        }
+    }
+
+    REQUIRE(found_existing_layer_body);
+    REQUIRE(concatenated == tbuilder.serialize());
+}
+
+TEST_CASE("Clear tile builder containing existing layers") {
+    const auto buffer = load_test_tile();
+    vtzero::vector_tile tile{buffer};
+
+    vtzero::tile_builder tbuilder;
+    while (auto layer = tile.next_layer()) {
+        tbuilder.add_existing_layer(layer);
+    }
+    REQUIRE(tbuilder.serialize() == buffer);
+
+    tbuilder.clear();
+    REQUIRE(tbuilder.serialize().empty());
+}
+
 TEST_CASE("Committing a feature succeeds after a geometry was added") {
     vtzero::tile_builder tbuilder;
     vtzero::layer_builder lbuilder{tbuilder, "test"};
@@ -394,6 +546,164 @@ TEST_CASE("Copy tile using geometry_feature_builder and property_mapper") {
     REQUIRE(vector_tile_equal(buffer, data));
 }
 
+TEST_CASE("Copy tile using layer_remapper") {
+    const auto buffer = load_test_tile();
+    vtzero::vector_tile tile{buffer};
+
+    vtzero::tile_builder tbuilder;
+
+    while (auto layer = tile.next_layer()) {
+        vtzero::layer_builder lbuilder{tbuilder, layer};
+        vtzero::layer_remapper remapper{layer, lbuilder};
+        while (auto feature = layer.next_feature()) {
+            remapper.copy_feature(feature);
+        }
+    }
+
+    const std::string data = tbuilder.serialize();
+    REQUIRE(vector_tile_equal(buffer, data));
+}
+
+TEST_CASE("Copy some features using layer_remapper") {
+    const auto buffer = load_test_tile();
+    vtzero::vector_tile tile{buffer};
+
+    vtzero::tile_builder tbuilder;
+
+    std::size_t num_features_copied = 0;
+    while (auto layer = tile.next_layer()) {
+        vtzero::layer_builder lbuilder{tbuilder, layer};
+        vtzero::layer_remapper remapper{layer, lbuilder};
+        while (auto feature = layer.next_feature()) {
+            if (feature.id() % 2 == 0) {
+                remapper.copy_feature(feature);
+                ++num_features_copied;
+            }
+        }
+    }
+
+    const std::string data = tbuilder.serialize();
+    vtzero::vector_tile result_tile{data};
+    std::size_t num_features = 0;
+    while (auto layer = result_tile.next_layer()) {
+        while (auto feature = layer.next_feature()) {
+            REQUIRE(feature.id() % 2 == 0);
+            ++num_features;
+        }
+    }
+    REQUIRE(num_features == num_features_copied);
+}
+
+TEST_CASE("Stream a tile layer by layer using flush_layers()") {
+    const auto buffer = load_test_tile();
+
+    std::string streamed;
+    const auto sink = [&streamed](const vtzero::data_view data) {
+        streamed.append(data.data(), data.size());
+    };
+
+    vtzero::tile_builder reference_tbuilder;
+    vtzero::tile_builder tbuilder;
+
+    vtzero::vector_tile tile{buffer};
+    while (auto layer = tile.next_layer()) {
+        reference_tbuilder.add_existing_layer(layer);
+        tbuilder.add_existing_layer(layer);
+        tbuilder.flush_layers(sink);
+    }
+
+    REQUIRE(streamed == reference_tbuilder.serialize());
+
+    // the builder is empty after streaming all layers
+    REQUIRE(tbuilder.serialize().empty());
+}
+
+TEST_CASE("Stream a tile with layers built from scratch using flush_layers()") {
+    vtzero::tile_builder reference_tbuilder;
+    vtzero::tile_builder tbuilder;
+
+    std::string streamed;
+    const auto sink = [&streamed](const vtzero::data_view data) {
+        streamed.append(data.data(), data.size());
+    };
+
+    for (const char* name : {"layer_1", "layer_2"}) {
+        for (auto* builder : {&reference_tbuilder, &tbuilder}) {
+            vtzero::layer_builder lbuilder{*builder, name};
+            vtzero::point_feature_builder fbuilder{lbuilder};
+            fbuilder.set_id(17);
+            fbuilder.add_point(10, 20);
+            fbuilder.add_property("key", "value");
+            fbuilder.commit();
+        }
+        tbuilder.flush_layers(sink);
+    }
+
+    REQUIRE(streamed == reference_tbuilder.serialize());
+}
+
+TEST_CASE("Copy tile splicing raw feature data") {
+    const auto buffer = load_test_tile();
+    vtzero::vector_tile tile{buffer};
+
+    vtzero::tile_builder tbuilder;
+
+    while (auto layer = tile.next_layer()) {
+        vtzero::layer_builder lbuilder{tbuilder, layer};
+        for (const auto& key : layer.key_table()) {
+            lbuilder.add_key_without_dup_check(key);
+        }
+        for (const auto& value : layer.value_table()) {
+            lbuilder.add_value_without_dup_check(value);
+        }
+        while (auto feature = layer.next_feature()) {
+            lbuilder.copy_feature(feature);
+        }
+    }
+
+    const std::string data = tbuilder.serialize();
+    REQUIRE(vector_tile_equal(buffer, data));
+}
+
+TEST_CASE("Copy features splicing raw feature data with new IDs") {
+    const auto buffer = load_test_tile();
+    vtzero::vector_tile tile{buffer};
+
+    vtzero::tile_builder tbuilder;
+
+    while (auto layer = tile.next_layer()) {
+        vtzero::layer_builder lbuilder{tbuilder, layer};
+        for (const auto& key : layer.key_table()) {
+            lbuilder.add_key_without_dup_check(key);
+        }
+        for (const auto& value : layer.value_table()) {
+            lbuilder.add_value_without_dup_check(value);
+        }
+        while (auto feature = layer.next_feature()) {
+            lbuilder.copy_feature(feature, feature.id() + 10000);
+        }
+    }
+
+    const std::string data = tbuilder.serialize();
+    vtzero::vector_tile result_tile{data};
+    vtzero::vector_tile orig_tile{buffer};
+    while (auto layer = result_tile.next_layer()) {
+        auto orig_layer = orig_tile.next_layer();
+        while (orig_layer.empty()) {
+            // empty layers are not copied to the new tile
+            orig_layer = orig_tile.next_layer();
+        }
+        REQUIRE(layer.num_features() == orig_layer.num_features());
+        while (auto feature = layer.next_feature()) {
+            const auto orig_feature = orig_layer.next_feature();
+            REQUIRE(feature.id() == orig_feature.id() + 10000);
+            REQUIRE(feature.geometry_type() == orig_feature.geometry_type());
+            REQUIRE(feature.geometry().data() == orig_feature.geometry().data());
+            REQUIRE(feature.num_properties() == orig_feature.num_properties());
+        }
+    }
+}
+
 TEST_CASE("Copy only point geometries using geometry_feature_builder") {
     const auto buffer = load_test_tile();
     vtzero::vector_tile tile{buffer};
@@ -569,3 +879,223 @@ TEST_CASE("Moving a feature builder is allowed") {
     vtzero::point_feature_builder fbuilder3{std::move(fbuilder2)};
 }
 
+
+TEST_CASE("Subset a layer using subset_layer()") {
+    const auto orig_data = load_test_tile();
+    const vtzero::vector_tile orig_tile{orig_data};
+    auto orig_layer = orig_tile.get_layer_by_name("building");
+    REQUIRE(orig_layer.num_features() == 937);
+
+    vtzero::tile_builder tbuilder;
+    vtzero::subset_layer(orig_layer, [](const vtzero::feature& feature) {
+        return feature.id() <= 100;
+    }, tbuilder);
+
+    const std::string data = tbuilder.serialize();
+    const vtzero::vector_tile tile{data};
+
+    const auto layer = tile.get_layer_by_name("building");
+    REQUIRE(layer.valid());
+    REQUIRE(layer.num_features() == 100);
+    REQUIRE(layer.version() == orig_layer.version());
+    REQUIRE(layer.extent() == orig_layer.extent());
+
+    // only the table entries referenced by surviving features were copied
+    REQUIRE(layer.key_table().size() <= orig_layer.key_table().size());
+    REQUIRE(layer.value_table().size() <= orig_layer.value_table().size());
+
+    // IDs, geometries, and properties survive the splice
+    const auto feature = layer.get_feature_by_id(7);
+    auto orig_feature = orig_layer.get_feature_by_id(7);
+    REQUIRE(feature.valid());
+    REQUIRE(feature.geometry_type() == orig_feature.geometry_type());
+    REQUIRE(feature.geometry().data() == orig_feature.geometry().data());
+    REQUIRE(feature.num_properties() == orig_feature.num_properties());
+    while (auto p = orig_feature.next_property()) {
+        const auto q = feature.get_property_by_key(p.key());
+        REQUIRE(q.valid());
+        REQUIRE(q.value() == p.value());
+    }
+}
+
+TEST_CASE("Subset dropping all features leaves the tile empty") {
+    const auto orig_data = load_test_tile();
+    const vtzero::vector_tile orig_tile{orig_data};
+    auto orig_layer = orig_tile.get_layer_by_name("building");
+
+    vtzero::tile_builder tbuilder;
+    vtzero::subset_layer(orig_layer, [](const vtzero::feature& /*feature*/) {
+        return false;
+    }, tbuilder);
+
+    REQUIRE(tbuilder.serialize().empty());
+}
+
+TEST_CASE("Add properties in bulk from pre-resolved indexes") {
+    // build the reference tile adding the properties one by one
+    vtzero::tile_builder tbuilder_plain;
+    vtzero::layer_builder lbuilder_plain{tbuilder_plain, "test"};
+    {
+        vtzero::point_feature_builder fbuilder{lbuilder_plain};
+        fbuilder.add_point(10, 20);
+        fbuilder.add_property("highway", "primary");
+        fbuilder.add_property("maxspeed", 50);
+        fbuilder.add_property("oneway", true);
+        fbuilder.commit();
+    }
+    const std::string plain_data = tbuilder_plain.serialize();
+
+    // intern the keys and values up front like a re-encoder would
+    vtzero::tile_builder tbuilder;
+    vtzero::layer_builder lbuilder{tbuilder, "test"};
+    const std::array<vtzero::index_value, 3> keys{{
+        lbuilder.add_key("highway"),
+        lbuilder.add_key("maxspeed"),
+        lbuilder.add_key("oneway")
+    }};
+    const std::array<vtzero::index_value, 3> values{{
+        lbuilder.add_value(vtzero::encoded_property_value{"primary"}),
+        lbuilder.add_value(vtzero::encoded_property_value{50}),
+        lbuilder.add_value(vtzero::encoded_property_value{true})
+    }};
+
+    SECTION("index_value_pair overload") {
+        const std::array<vtzero::index_value_pair, 3> props{{
+            {keys[0], values[0]},
+            {keys[1], values[1]},
+            {keys[2], values[2]}
+        }};
+        vtzero::point_feature_builder fbuilder{lbuilder};
+        fbuilder.add_point(10, 20);
+        fbuilder.add_properties(props.data(), props.data() + props.size());
+        fbuilder.commit();
+    }
+
+    SECTION("raw uint32_t overload") {
+        const std::array<uint32_t, 6> tags{{
+            keys[0].value(), values[0].value(),
+            keys[1].value(), values[1].value(),
+            keys[2].value(), values[2].value()
+        }};
+        vtzero::point_feature_builder fbuilder{lbuilder};
+        fbuilder.add_point(10, 20);
+        fbuilder.add_properties(tags.data(), tags.data() + tags.size());
+        fbuilder.commit();
+    }
+
+    SECTION("mixing with add_property()") {
+        const std::array<uint32_t, 4> tags{{
+            keys[0].value(), values[0].value(),
+            keys[1].value(), values[1].value()
+        }};
+        vtzero::point_feature_builder fbuilder{lbuilder};
+        fbuilder.add_point(10, 20);
+        fbuilder.add_properties(tags.data(), tags.data() + tags.size());
+        fbuilder.add_property(keys[2], values[2]);
+        fbuilder.commit();
+    }
+
+    // the bulk API produces exactly the same encoding
+    REQUIRE(tbuilder.serialize() == plain_data);
+}
+
+TEST_CASE("Add empty range of properties in bulk") {
+    vtzero::tile_builder tbuilder;
+    vtzero::layer_builder lbuilder{tbuilder, "test"};
+    vtzero::point_feature_builder fbuilder{lbuilder};
+    fbuilder.add_point(10, 20);
+    const vtzero::index_value_pair* none = nullptr;
+    fbuilder.add_properties(none, none);
+    fbuilder.commit();
+
+    const std::string data = tbuilder.serialize();
+    vtzero::vector_tile tile{data};
+    auto layer = tile.next_layer();
+    const auto feature = layer.next_feature();
+    REQUIRE(feature.num_properties() == 0);
+}
+
+TEST_CASE("Build layers standalone and attach them to a tile") {
+    // the reference tile built the conventional way
+    vtzero::tile_builder tbuilder_plain;
+    {
+        vtzero::layer_builder lbuilder{tbuilder_plain, "roads"};
+        vtzero::point_feature_builder fbuilder{lbuilder};
+        fbuilder.add_point(10, 20);
+        fbuilder.add_property("highway", "primary");
+        fbuilder.commit();
+    }
+    {
+        vtzero::layer_builder lbuilder{tbuilder_plain, "pois", 2, 512};
+        vtzero::point_feature_builder fbuilder{lbuilder};
+        fbuilder.add_point(3, 4);
+        fbuilder.commit();
+    }
+    const std::string plain_data = tbuilder_plain.serialize();
+
+    vtzero::standalone_layer_builder roads{"roads"};
+    vtzero::standalone_layer_builder pois{"pois", 2, 512};
+
+    SECTION("filled on this thread") {
+        vtzero::point_feature_builder fbuilder{roads};
+        fbuilder.add_point(10, 20);
+        fbuilder.add_property("highway", "primary");
+        fbuilder.commit();
+
+        vtzero::point_feature_builder fbuilder2{pois};
+        fbuilder2.add_point(3, 4);
+        fbuilder2.commit();
+    }
+
+    SECTION("filled on worker threads") {
+        std::thread t1{[&roads]() {
+            vtzero::point_feature_builder fbuilder{roads};
+            fbuilder.add_point(10, 20);
+            fbuilder.add_property("highway", "primary");
+            fbuilder.commit();
+        }};
+        std::thread t2{[&pois]() {
+            vtzero::point_feature_builder fbuilder{pois};
+            fbuilder.add_point(3, 4);
+            fbuilder.commit();
+        }};
+        t1.join();
+        t2.join();
+    }
+
+    vtzero::tile_builder tbuilder;
+    tbuilder.attach_layer(std::move(roads));
+    tbuilder.attach_layer(std::move(pois));
+
+    // attaching the layers in order produces exactly the same tile
+    REQUIRE(tbuilder.serialize() == plain_data);
+}
+
+TEST_CASE("Attached standalone layers mix with other layers") {
+    vtzero::standalone_layer_builder standalone{"second"};
+    {
+        vtzero::point_feature_builder fbuilder{standalone};
+        fbuilder.add_point(1, 1);
+        fbuilder.commit();
+    }
+
+    // an empty standalone layer is not written out, like any other
+    // empty layer
+    vtzero::standalone_layer_builder empty{"empty"};
+
+    vtzero::tile_builder tbuilder;
+    {
+        vtzero::layer_builder lbuilder{tbuilder, "first"};
+        vtzero::point_feature_builder fbuilder{lbuilder};
+        fbuilder.add_point(2, 2);
+        fbuilder.commit();
+    }
+    tbuilder.attach_layer(std::move(standalone));
+    tbuilder.attach_layer(std::move(empty));
+
+    const std::string data = tbuilder.serialize();
+    vtzero::vector_tile tile{data};
+    REQUIRE(tile.count_layers() == 2);
+    REQUIRE(tile.get_layer(0).name() == "first");
+    REQUIRE(tile.get_layer(1).name() == "second");
+}
@@ -227,6 +227,10 @@ TEST_CASE("Add linestring from container") {
             fbuilder.add_linestring_from_container(points[0]);
         }
 
+        SECTION("using a point span") {
+            fbuilder.add_linestring(points[0].data(), points[0].data() + points[0].size());
+        }
+
         fbuilder.commit();
     }
 
@@ -263,6 +267,17 @@ TEST_CASE("Add linestring from iterator with wrong count throws assert") {
 }
 #endif
 
+TEST_CASE("Add linestring from span with zero-length segment throws") {
+    const std::vector<vtzero::point> points = {{10, 20}, {20, 30}, {20, 30}};
+
+    vtzero::tile_builder tbuilder;
+    vtzero::layer_builder lbuilder{tbuilder, "test"};
+    vtzero::linestring_feature_builder fbuilder{lbuilder};
+
+    REQUIRE_THROWS_AS(fbuilder.add_linestring(points.data(), points.data() + points.size()),
+                      vtzero::geometry_exception);
+}
+
 TEST_CASE("Adding several linestrings with feature rollback in the middle") {
     vtzero::tile_builder tbuilder;
     vtzero::layer_builder lbuilder{tbuilder, "test"};
@@ -310,3 +325,25 @@ TEST_CASE("Adding several linestrings with feature rollback in the middle") {
     REQUIRE(feature.id() == 3);
 }
 
+
+TEST_CASE("linestring builder with reserve hint produces the same data") {
+    std::string plain_data;
+    std::string reserved_data;
+
+    for (std::string* output : {&plain_data, &reserved_data}) {
+        vtzero::tile_builder tbuilder;
+        vtzero::layer_builder lbuilder{tbuilder, "test"};
+        vtzero::linestring_feature_builder fbuilder{lbuilder};
+
+        fbuilder.add_linestring(100, output == &reserved_data);
+        for (int32_t n = 0; n < 100; ++n) {
+            fbuilder.set_point(n * 10, n * 7);
+        }
+        fbuilder.commit();
+
+        *output = tbuilder.serialize();
+    }
+
+    REQUIRE_FALSE(plain_data.empty());
+    REQUIRE(plain_data == reserved_data);
+}
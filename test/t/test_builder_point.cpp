@@ -243,6 +243,10 @@ TEST_CASE("Add points from container") {
             fbuilder.add_points_from_container(points);
         }
 
+        SECTION("using a point span") {
+            fbuilder.add_points(points.data(), points.data() + points.size());
+        }
+
         fbuilder.commit();
     }
 
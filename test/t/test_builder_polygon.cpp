@@ -246,6 +246,17 @@ TEST_CASE("Calling polygon_feature_builder::set_point() creating unclosed ring t
     REQUIRE_THROWS_AS(fbuilder.set_point(20, 30), vtzero::geometry_exception);
 }
 
+TEST_CASE("Add ring from span creating unclosed ring throws") {
+    const std::vector<vtzero::point> points = {{10, 10}, {10, 20}, {20, 20}, {20, 30}};
+
+    vtzero::tile_builder tbuilder;
+    vtzero::layer_builder lbuilder{tbuilder, "test"};
+    vtzero::polygon_feature_builder fbuilder{lbuilder};
+
+    REQUIRE_THROWS_AS(fbuilder.add_ring(points.data(), points.data() + points.size()),
+                      vtzero::geometry_exception);
+}
+
 TEST_CASE("Add polygon from container") {
     const polygon_type points = {{{10, 20}, {20, 30}, {30, 40}, {10, 20}}};
 
@@ -269,6 +280,10 @@ TEST_CASE("Add polygon from container") {
             fbuilder.add_ring_from_container(points[0]);
         }
 
+        SECTION("using a point span") {
+            fbuilder.add_ring(points[0].data(), points[0].data() + points[0].size());
+        }
+
         fbuilder.commit();
     }
 
@@ -305,3 +320,26 @@ TEST_CASE("Add polygon from iterator with wrong count throws assert") {
 }
 #endif
 
+
+TEST_CASE("polygon builder with reserve hint produces the same data") {
+    std::string plain_data;
+    std::string reserved_data;
+
+    for (std::string* output : {&plain_data, &reserved_data}) {
+        vtzero::tile_builder tbuilder;
+        vtzero::layer_builder lbuilder{tbuilder, "test"};
+        vtzero::polygon_feature_builder fbuilder{lbuilder};
+
+        fbuilder.add_ring(101, output == &reserved_data);
+        for (int32_t n = 0; n < 100; ++n) {
+            fbuilder.set_point(100 + (n % 10) * 10, 100 + (n / 10) * 10 + (n % 10));
+        }
+        fbuilder.set_point(100, 100); // close the ring
+        fbuilder.commit();
+
+        *output = tbuilder.serialize();
+    }
+
+    REQUIRE_FALSE(plain_data.empty());
+    REQUIRE(plain_data == reserved_data);
+}
@@ -5,6 +5,10 @@
 #include <vtzero/layer.hpp>
 #include <vtzero/vector_tile.hpp>
 
+#include <cstdint>
+#include <string>
+#include <vector>
+
 TEST_CASE("default constructed feature") {
     vtzero::feature feature{};
 
@@ -63,9 +67,89 @@ TEST_CASE("iterate over all properties of a feature") {
         });
     }
 
+    SECTION("internal iterator with scratch buffer") {
+        std::vector<uint32_t> scratch;
+        feature.for_each_property([&count](const vtzero::property& p) {
+            ++count;
+            if (p.key() == "type") {
+                REQUIRE(p.value().type() == vtzero::property_value_type::string_value);
+                REQUIRE(p.value().string_value() == "primary");
+            }
+            return true;
+        }, scratch);
+        REQUIRE(scratch.size() == 8);
+    }
+
     REQUIRE(count == 4);
 }
 
+TEST_CASE("decode all property indexes of a feature in one go") {
+    const auto data = load_test_tile();
+    vtzero::vector_tile tile{data};
+    auto layer = tile.get_layer_by_name("bridge");
+    auto feature = layer.next_feature();
+
+    std::vector<uint32_t> scratch;
+    feature.decode_property_indexes(scratch);
+    REQUIRE(scratch.size() == feature.num_properties() * 2);
+
+    // must match what the pair-wise iteration gives us
+    std::vector<uint32_t> indexes;
+    feature.for_each_property_indexes([&indexes](const vtzero::index_value_pair idxs) {
+        indexes.push_back(idxs.key().value());
+        indexes.push_back(idxs.value().value());
+        return true;
+    });
+    REQUIRE(scratch == indexes);
+}
+
+TEST_CASE("get property of a feature by key") {
+    const auto data = load_test_tile();
+    vtzero::vector_tile tile{data};
+    auto layer = tile.get_layer_by_name("bridge");
+    REQUIRE(layer.valid());
+
+    auto feature = layer.next_feature();
+    REQUIRE(feature.valid());
+
+    SECTION("data_view overload") {
+        const std::string key{"type"};
+        const auto p = feature.get_property_by_key(vtzero::data_view{key.data(), key.size()});
+        REQUIRE(p.valid());
+        REQUIRE(p.key() == "type");
+        REQUIRE(p.value().string_value() == "primary");
+    }
+
+    SECTION("std::string overload") {
+        const auto p = feature.get_property_by_key(std::string{"oneway"});
+        REQUIRE(p.valid());
+        REQUIRE(p.key() == "oneway");
+    }
+
+    SECTION("const char* overload") {
+        const auto p = feature.get_property_by_key("class");
+        REQUIRE(p.valid());
+        REQUIRE(p.key() == "class");
+        REQUIRE(p.value().string_value() == "main");
+    }
+
+    SECTION("key not in the layer key table") {
+        const auto p = feature.get_property_by_key("no_such_key");
+        REQUIRE_FALSE(p.valid());
+    }
+
+    SECTION("does not affect the property iterator") {
+        REQUIRE(feature.next_property().valid());
+        REQUIRE(feature.get_property_by_key("type").valid());
+
+        int count = 1;
+        while (feature.next_property()) {
+            ++count;
+        }
+        REQUIRE(count == 4);
+    }
+}
+
 TEST_CASE("iterate over some properties of a feature") {
     const auto data = load_test_tile();
     vtzero::vector_tile tile{data};
@@ -3,8 +3,11 @@
 
 #include <vtzero/geometry.hpp>
 
+#include <array>
 #include <cstdint>
 #include <limits>
+#include <list>
+#include <string>
 #include <vector>
 
 using container = std::vector<uint32_t>;
@@ -332,3 +335,238 @@ TEST_CASE("geometry_decoder with multipoint with not enough points") {
     REQUIRE_THROWS_AS(decoder.next_command(vtzero::detail::CommandId::MOVE_TO), vtzero::geometry_exception);
 }
 
+
+TEST_CASE("geometry_decoder bulk decoding with next_points()") {
+    const container g = {17, 10, 14, 3, 9};
+
+    vtzero::detail::geometry_decoder<iterator> decoder{g.cbegin(), g.cend(), g.size() / 2};
+
+    REQUIRE(decoder.next_command(vtzero::detail::CommandId::MOVE_TO));
+    REQUIRE(decoder.count() == 2);
+
+    std::array<vtzero::point, 2> buffer;
+    REQUIRE(decoder.next_points(buffer.data()) == 2);
+    REQUIRE(decoder.count() == 0);
+    REQUIRE(buffer[0] == vtzero::point(5, 7));
+    REQUIRE(buffer[1] == vtzero::point(3, 2));
+
+    REQUIRE(decoder.done());
+    REQUIRE_FALSE(decoder.next_command(vtzero::detail::CommandId::MOVE_TO));
+}
+
+TEST_CASE("geometry_decoder bulk decoding with forward iterators") {
+    const container data = {9, 4, 4, 18, 0, 16, 16, 0};
+    const std::list<uint32_t> g{data.cbegin(), data.cend()};
+
+    vtzero::detail::geometry_decoder<std::list<uint32_t>::const_iterator> decoder{g.cbegin(), g.cend(), g.size() / 2};
+
+    std::array<vtzero::point, 2> buffer;
+
+    REQUIRE(decoder.next_command(vtzero::detail::CommandId::MOVE_TO));
+    REQUIRE(decoder.next_points(buffer.data()) == 1);
+    REQUIRE(buffer[0] == vtzero::point(2, 2));
+
+    REQUIRE(decoder.next_command(vtzero::detail::CommandId::LINE_TO));
+    REQUIRE(decoder.next_points(buffer.data()) == 2);
+    REQUIRE(buffer[0] == vtzero::point(2, 10));
+    REQUIRE(buffer[1] == vtzero::point(10, 10));
+
+    REQUIRE(decoder.done());
+}
+
+TEST_CASE("geometry_decoder bulk decoding with not enough points") {
+    const container g = {vtzero::detail::command_move_to(2), 10, 10};
+
+    vtzero::detail::geometry_decoder<iterator> decoder{g.cbegin(), g.cend(), 100};
+
+    REQUIRE(decoder.next_command(vtzero::detail::CommandId::MOVE_TO));
+    REQUIRE(decoder.count() == 2);
+
+    std::array<vtzero::point, 2> buffer;
+    REQUIRE_THROWS_AS(decoder.next_points(buffer.data()), vtzero::geometry_exception);
+}
+
+TEST_CASE("geometry_decoder with trusted policy decodes valid data") {
+    const container g = {vtzero::detail::command_move_to(2), 10, 10, 20, 20};
+
+    vtzero::detail::geometry_decoder<iterator, vtzero::trusted> decoder{g.cbegin(), g.cend(), g.size() / 2};
+
+    REQUIRE(decoder.next_command(vtzero::detail::CommandId::MOVE_TO));
+    REQUIRE(decoder.count() == 2);
+    REQUIRE(decoder.next_point() == vtzero::point(5, 5));
+    REQUIRE(decoder.next_point() == vtzero::point(15, 15));
+    REQUIRE(decoder.done());
+    REQUIRE_FALSE(decoder.next_command(vtzero::detail::CommandId::MOVE_TO));
+}
+
+struct transform_test_handler {
+
+    std::vector<vtzero::point> points{};
+
+    void linestring_begin(uint32_t count) {
+        points.reserve(count);
+    }
+
+    void linestring_point(const vtzero::point point) {
+        points.push_back(point);
+    }
+
+    void linestring_end() const noexcept {
+    }
+
+    void ring_begin(uint32_t count) {
+        points.reserve(count);
+    }
+
+    void ring_point(const vtzero::point point) {
+        points.push_back(point);
+    }
+
+    void ring_end(vtzero::ring_type /*rt*/) const noexcept {
+    }
+
+};
+
+TEST_CASE("transform_geometry scales and translates a linestring") {
+    // MoveTo(1): (2, 2), LineTo(1): (10, 10)
+    const std::string data{9, 4, 4, 10, 16, 16};
+    const vtzero::geometry geometry{vtzero::data_view{data}, vtzero::GeomType::LINESTRING};
+
+    std::string output;
+    vtzero::transform_geometry(geometry, 2, 3, 5, output);
+
+    const vtzero::geometry result{vtzero::data_view{output}, vtzero::GeomType::LINESTRING};
+    transform_test_handler handler;
+    vtzero::decode_linestring_geometry(result, handler);
+
+    REQUIRE(handler.points.size() == 2);
+    REQUIRE(handler.points[0] == vtzero::point(7, 9));
+    REQUIRE(handler.points[1] == vtzero::point(23, 25));
+}
+
+TEST_CASE("transform_geometry copies ClosePath commands unchanged") {
+    // MoveTo(1): (1, 1), LineTo(2): (5, 1), (5, 5), ClosePath
+    const std::string data{9, 2, 2, 18, 8, 0, 0, 8, 15};
+    const vtzero::geometry geometry{vtzero::data_view{data}, vtzero::GeomType::POLYGON};
+
+    std::string output;
+    vtzero::transform_geometry(geometry, 2, 0, 0, output);
+
+    const vtzero::geometry result{vtzero::data_view{output}, vtzero::GeomType::POLYGON};
+    transform_test_handler handler;
+    vtzero::decode_polygon_geometry(result, handler);
+
+    REQUIRE(handler.points.size() == 4);
+    REQUIRE(handler.points[0] == vtzero::point(2, 2));
+    REQUIRE(handler.points[1] == vtzero::point(10, 2));
+    REQUIRE(handler.points[2] == vtzero::point(10, 10));
+    REQUIRE(handler.points[3] == vtzero::point(2, 2));
+}
+
+TEST_CASE("transform_geometry throws on unknown command") {
+    const std::string data{11, 0, 0}; // command id 3 doesn't exist
+    const vtzero::geometry geometry{vtzero::data_view{data}, vtzero::GeomType::LINESTRING};
+
+    std::string output;
+    REQUIRE_THROWS_AS(vtzero::transform_geometry(geometry, 2, 0, 0, output), vtzero::geometry_exception);
+}
+
+TEST_CASE("decode_bounding_box of an empty geometry is invalid") {
+    const vtzero::geometry geometry{};
+    REQUIRE_FALSE(vtzero::decode_bounding_box(geometry).valid());
+}
+
+TEST_CASE("decode_bounding_box of a point geometry") {
+    // MoveTo(1): (-3, -4)
+    const std::string data{9, 5, 7};
+    const vtzero::geometry geometry{vtzero::data_view{data}, vtzero::GeomType::POINT};
+
+    const auto bbox = vtzero::decode_bounding_box(geometry);
+    REQUIRE(bbox.valid());
+    REQUIRE(bbox.min == vtzero::point(-3, -4));
+    REQUIRE(bbox.max == vtzero::point(-3, -4));
+}
+
+TEST_CASE("decode_bounding_box of a linestring geometry") {
+    // MoveTo(1): (2, 2), LineTo(1): (10, 10)
+    const std::string data{9, 4, 4, 10, 16, 16};
+    const vtzero::geometry geometry{vtzero::data_view{data}, vtzero::GeomType::LINESTRING};
+
+    const auto bbox = vtzero::decode_bounding_box(geometry);
+    REQUIRE(bbox.min == vtzero::point(2, 2));
+    REQUIRE(bbox.max == vtzero::point(10, 10));
+    REQUIRE(bbox.contains(vtzero::point(5, 7)));
+    REQUIRE_FALSE(bbox.contains(vtzero::point(11, 7)));
+}
+
+TEST_CASE("decode_bounding_box of a polygon geometry skips ClosePath") {
+    // MoveTo(1): (1, 1), LineTo(2): (5, 1), (5, 5), ClosePath
+    const std::string data{9, 2, 2, 18, 8, 0, 0, 8, 15};
+    const vtzero::geometry geometry{vtzero::data_view{data}, vtzero::GeomType::POLYGON};
+
+    const auto bbox = vtzero::decode_bounding_box(geometry);
+    REQUIRE(bbox.min == vtzero::point(1, 1));
+    REQUIRE(bbox.max == vtzero::point(5, 5));
+}
+
+struct area_test_handler {
+
+    std::vector<int64_t> twice_areas{};
+    std::vector<vtzero::ring_type> types{};
+
+    void ring_begin(uint32_t /*count*/) const noexcept {
+    }
+
+    void ring_point(const vtzero::point /*point*/) const noexcept {
+    }
+
+    void ring_end(vtzero::ring_type rt, int64_t twice_area) {
+        types.push_back(rt);
+        twice_areas.push_back(twice_area);
+    }
+
+};
+
+TEST_CASE("decode_polygon_geometry passes the ring area to the handler") {
+    // MoveTo(1): (1, 1), LineTo(2): (5, 1), (5, 5), ClosePath
+    const std::string data{9, 2, 2, 18, 8, 0, 0, 8, 15};
+    const vtzero::geometry geometry{vtzero::data_view{data}, vtzero::GeomType::POLYGON};
+
+    area_test_handler handler;
+    vtzero::decode_polygon_geometry(geometry, handler);
+
+    REQUIRE(handler.types.size() == 1);
+    REQUIRE(handler.types[0] == vtzero::ring_type::outer);
+    // triangle (1,1), (5,1), (5,5) has area 8
+    REQUIRE(handler.twice_areas[0] == 16);
+}
+
+TEST_CASE("geometry_stats of an empty geometry") {
+    const auto stats = vtzero::geometry_stats(vtzero::geometry{});
+    REQUIRE(stats.num_points == 0);
+    REQUIRE(stats.num_parts == 0);
+    REQUIRE(stats.longest_part == 0);
+}
+
+TEST_CASE("geometry_stats of a multilinestring geometry") {
+    // MoveTo(1): (2, 2), LineTo(2): (4, 4), (6, 6),
+    // MoveTo(1): (8, 8), LineTo(1): (10, 10)
+    const std::string data{9, 4, 4, 18, 4, 4, 4, 4, 9, 4, 4, 10, 4, 4};
+    const vtzero::geometry geometry{vtzero::data_view{data}, vtzero::GeomType::LINESTRING};
+
+    const auto stats = vtzero::geometry_stats(geometry);
+    REQUIRE(stats.num_points == 5);
+    REQUIRE(stats.num_parts == 2);
+    REQUIRE(stats.longest_part == 3);
+}
+
+TEST_CASE("geometry_stats of a polygon geometry") {
+    // MoveTo(1): (1, 1), LineTo(2): (5, 1), (5, 5), ClosePath
+    const std::string data{9, 2, 2, 18, 8, 0, 0, 8, 15};
+    const vtzero::geometry geometry{vtzero::data_view{data}, vtzero::GeomType::POLYGON};
+
+    const auto stats = vtzero::geometry_stats(geometry);
+    REQUIRE(stats.num_points == 3);
+    REQUIRE(stats.num_parts == 1);
+    REQUIRE(stats.longest_part == 3);
+}
@@ -91,6 +91,10 @@ TEST_CASE("key index based on std::map") {
     test_key_index<vtzero::key_index<std::map>>();
 }
 
+TEST_CASE("key index based on vtzero::flat_map") {
+    test_key_index<vtzero::key_index<>>();
+}
+
 template <typename TIndex>
 static void test_value_index_internal() {
     vtzero::tile_builder tbuilder;
@@ -141,6 +145,10 @@ TEST_CASE("internal value index based on std::map") {
     test_value_index_internal<vtzero::value_index_internal<std::map>>();
 }
 
+TEST_CASE("internal value index based on vtzero::flat_map") {
+    test_value_index_internal<vtzero::value_index_internal<>>();
+}
+
 TEST_CASE("external value index") {
     vtzero::tile_builder tbuilder;
     vtzero::layer_builder lbuilder{tbuilder, "test"};
@@ -279,6 +287,11 @@ TEST_CASE("add features using a key index") {
         fbuilder.add_property(index("some_key"), 12);
     }
 
+    SECTION("key index using flat_map") {
+        vtzero::key_index<> index{lbuilder};
+        fbuilder.add_property(index("some_key"), 12);
+    }
+
     fbuilder.commit();
 
     const std::string data = tbuilder.serialize();
@@ -319,6 +332,11 @@ TEST_CASE("add features using a value index") {
         fbuilder.add_property(key, index(12));
     }
 
+    SECTION("external value index using flat_map") {
+        vtzero::value_index<vtzero::sint_value_type, int> index{lbuilder};
+        fbuilder.add_property(key, index(12));
+    }
+
     SECTION("property_value_type index") {
         vtzero::value_index_internal<std::unordered_map> index{lbuilder};
         fbuilder.add_property(key, index(vtzero::encoded_property_value{vtzero::sint_value_type{12}}));
@@ -341,3 +359,136 @@ TEST_CASE("add features using a value index") {
     REQUIRE(property.value().sint_value() == 12);
 }
 
+
+TEST_CASE("flat_map grows beyond its initial capacity") {
+    vtzero::flat_map<std::string, vtzero::index_value> map;
+    REQUIRE(map.size() == 0);
+
+    for (uint32_t n = 0; n < 100; ++n) {
+        map.emplace("key" + std::to_string(n), vtzero::index_value{n});
+    }
+    REQUIRE(map.size() == 100);
+
+    // adding an existing key doesn't change anything
+    map.emplace(std::string{"key7"}, vtzero::index_value{999});
+    REQUIRE(map.size() == 100);
+
+    for (uint32_t n = 0; n < 100; ++n) {
+        const std::string key{"key" + std::to_string(n)};
+
+        // probing with a data_view must find the same entry
+        const auto it = map.find(vtzero::data_view{key});
+        REQUIRE_FALSE(it == map.end());
+        REQUIRE(it->second.value() == n);
+    }
+
+    REQUIRE(map.find(vtzero::data_view{"no-such-key"}) == map.end());
+}
+
+TEST_CASE("pooled key/value indexes shared between layers") {
+    vtzero::tile_builder tbuilder;
+    vtzero::string_pool pool;
+
+    for (const char* layer_name : {"one", "two"}) {
+        vtzero::layer_builder lbuilder{tbuilder, layer_name};
+        vtzero::pooled_key_index key_index{lbuilder, pool};
+        vtzero::pooled_value_index value_index{lbuilder, pool};
+
+        vtzero::point_feature_builder fbuilder{lbuilder};
+        fbuilder.set_id(1);
+        fbuilder.add_point(10, 20);
+
+        const auto k1 = key_index("name");
+        const auto k2 = key_index("class");
+        const auto k3 = key_index("name");
+        REQUIRE(k1 == k3);
+        REQUIRE(k1 != k2);
+
+        fbuilder.add_property(k1, value_index(vtzero::encoded_property_value{"foo"}));
+        fbuilder.add_property(k2, value_index(vtzero::encoded_property_value{"foo"}));
+        fbuilder.commit();
+    }
+
+    // both layers use the same keys and value, each string is in the
+    // pool only once
+    REQUIRE(pool.size() == 3);
+
+    const std::string data = tbuilder.serialize();
+    vtzero::vector_tile tile{data};
+    REQUIRE(tile.count_layers() == 2);
+    while (auto layer = tile.next_layer()) {
+        REQUIRE(layer.key_table().size() == 2);
+        REQUIRE(layer.value_table().size() == 1);
+        auto feature = layer.next_feature();
+        const auto property = feature.next_property();
+        REQUIRE(property.key() == "name");
+        REQUIRE(property.value().string_value() == "foo");
+    }
+}
+
+TEST_CASE("flat_map reserve avoids rehashing but keeps entries findable") {
+    vtzero::flat_map<std::string, vtzero::index_value> map;
+    map.reserve(100);
+
+    for (uint32_t n = 0; n < 100; ++n) {
+        map.emplace("key" + std::to_string(n), vtzero::index_value{n});
+    }
+    REQUIRE(map.size() == 100);
+
+    for (uint32_t n = 0; n < 100; ++n) {
+        const std::string key{"key" + std::to_string(n)};
+        const auto it = map.find(vtzero::data_view{key});
+        REQUIRE_FALSE(it == map.end());
+        REQUIRE(it->second.value() == n);
+    }
+
+    // reserving on a non-empty map keeps the entries, too
+    map.reserve(1000);
+    REQUIRE(map.find(vtzero::data_view{"key42"})->second.value() == 42);
+}
+
+TEST_CASE("key index handles input grouped by key") {
+    vtzero::tile_builder tbuilder;
+    vtzero::layer_builder lbuilder{tbuilder, "test"};
+    vtzero::key_index<> index{lbuilder};
+
+    index.reserve(3);
+
+    // grouped input hits the last-hit memo
+    for (int n = 0; n < 1000; ++n) {
+        REQUIRE(index("highway") == vtzero::index_value{0});
+    }
+    for (int n = 0; n < 1000; ++n) {
+        REQUIRE(index("name") == vtzero::index_value{1});
+    }
+
+    // going back to an earlier key must still find the old entry
+    REQUIRE(index("highway") == vtzero::index_value{0});
+    REQUIRE(index("name") == vtzero::index_value{1});
+    REQUIRE(index("oneway") == vtzero::index_value{2});
+}
+
+TEST_CASE("value indexes handle input grouped by value") {
+    vtzero::tile_builder tbuilder;
+    vtzero::layer_builder lbuilder{tbuilder, "test"};
+
+    vtzero::value_index<vtzero::string_value_type, std::string> index{lbuilder};
+    index.reserve(2);
+
+    for (int n = 0; n < 1000; ++n) {
+        REQUIRE(index("primary") == vtzero::index_value{0});
+    }
+    REQUIRE(index("secondary") == vtzero::index_value{1});
+    REQUIRE(index("primary") == vtzero::index_value{0});
+
+    vtzero::value_index_internal<> internal_index{lbuilder};
+    internal_index.reserve(2);
+
+    const vtzero::encoded_property_value one{17};
+    const vtzero::encoded_property_value two{22};
+    for (int n = 0; n < 1000; ++n) {
+        REQUIRE(internal_index(one) == vtzero::index_value{2});
+    }
+    REQUIRE(internal_index(two) == vtzero::index_value{3});
+    REQUIRE(internal_index(one) == vtzero::index_value{2});
+}
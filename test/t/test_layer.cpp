@@ -1,10 +1,14 @@
 
 #include <test.hpp>
 
+#include <vtzero/builder.hpp>
 #include <vtzero/layer.hpp>
 #include <vtzero/vector_tile.hpp>
 
 #include <cstddef>
+#include <iterator>
+#include <thread>
+#include <vector>
 
 TEST_CASE("default constructed layer") {
     vtzero::layer layer{};
@@ -89,6 +93,98 @@ TEST_CASE("access features in a layer by id") {
     REQUIRE_FALSE(layer.get_feature_by_id(999999));
 }
 
+TEST_CASE("access features in a layer by id using the feature index") {
+    const auto data = load_test_tile();
+    vtzero::vector_tile tile{data};
+
+    auto layer = tile.get_layer_by_name("building");
+    REQUIRE(layer);
+
+    REQUIRE_FALSE(layer.has_feature_index());
+    layer.build_feature_index();
+    REQUIRE(layer.has_feature_index());
+
+    // building the index a second time does nothing
+    layer.build_feature_index();
+
+    const auto feature = layer.get_feature_by_id(122);
+    REQUIRE(feature.id() == 122);
+    REQUIRE(feature.geometry_type() == vtzero::GeomType::POLYGON);
+
+    REQUIRE_FALSE(layer.get_feature_by_id(844));
+    REQUIRE_FALSE(layer.get_feature_by_id(999999));
+}
+
+TEST_CASE("query features near a point using the spatial index") {
+    const auto data = load_test_tile();
+    vtzero::vector_tile tile{data};
+
+    auto layer = tile.get_layer_by_name("building");
+    REQUIRE(layer);
+
+    REQUIRE_FALSE(layer.has_spatial_index());
+    layer.build_spatial_index(4);
+    REQUIRE(layer.has_spatial_index());
+
+    // building the index a second time does nothing
+    layer.build_spatial_index(2);
+
+    const auto feature = layer.get_feature_by_id(122);
+    REQUIRE(feature);
+    const auto bbox = vtzero::decode_bounding_box(feature.geometry());
+    REQUIRE(bbox.valid());
+    const vtzero::point center{(bbox.min.x + bbox.max.x) / 2,
+                               (bbox.min.y + bbox.max.y) / 2};
+
+    std::size_t count = 0;
+    bool found = false;
+    const bool completed = layer.for_each_feature_near(center, [&](const vtzero::feature& candidate) {
+        ++count;
+        if (candidate.id() == 122) {
+            found = true;
+        }
+        return true;
+    });
+
+    REQUIRE(completed);
+    REQUIRE(found);
+    REQUIRE(count > 0);
+    REQUIRE(count < layer.num_features());
+
+    // stopping the iteration early
+    count = 0;
+    REQUIRE_FALSE(layer.for_each_feature_near(center, [&count](const vtzero::feature& /*candidate*/) {
+        ++count;
+        return false;
+    }));
+    REQUIRE(count == 1);
+}
+
+TEST_CASE("access features in a layer by index") {
+    const auto data = load_test_tile();
+    vtzero::vector_tile tile{data};
+
+    auto layer = tile.get_layer_by_name("building");
+    REQUIRE(layer);
+
+    SECTION("without feature index") {
+    }
+
+    SECTION("with feature index") {
+        layer.build_feature_index();
+    }
+
+    const auto first = layer.get_feature(0);
+    REQUIRE(first);
+    REQUIRE(first.id() == 1);
+
+    const auto last = layer.get_feature(936);
+    REQUIRE(last);
+    REQUIRE(last.geometry_type() == vtzero::GeomType::POLYGON);
+
+    REQUIRE_FALSE(layer.get_feature(937));
+}
+
 TEST_CASE("iterate over all features in a layer") {
     const auto data = load_test_tile();
     vtzero::vector_tile tile{data};
@@ -153,3 +249,194 @@ TEST_CASE("iterate over some features in a layer") {
     REQUIRE(feature.id() == 1);
 }
 
+TEST_CASE("initialize key/value tables from several threads") {
+    const auto data = load_test_tile();
+    vtzero::vector_tile tile{data};
+
+    const auto layer = tile.get_layer_by_name("bridge");
+    REQUIRE(layer);
+
+    // catch assertions are not thread-safe, so only collect the results
+    // in the threads and check them after the join
+    std::vector<std::size_t> sizes(4, 0);
+    std::vector<std::thread> threads;
+    threads.reserve(4);
+    for (std::size_t n = 0; n < 4; ++n) {
+        threads.emplace_back([&layer, &sizes, n]() {
+            sizes[n] = layer.key_table().size() + layer.value_table().size();
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    for (const auto size : sizes) {
+        REQUIRE(size == 8);
+    }
+
+    REQUIRE(layer.key_table()[0] == "class");
+    REQUIRE(layer.value_table()[0].string_value() == "main");
+}
+
+TEST_CASE("copy a layer with initialized tables") {
+    const auto data = load_test_tile();
+    vtzero::vector_tile tile{data};
+
+    auto layer = tile.get_layer_by_name("bridge");
+    REQUIRE(layer.key_table().size() == 4);
+
+    const vtzero::layer copy{layer}; // NOLINT(performance-unnecessary-copy-initialization)
+    REQUIRE(copy.key_table().size() == 4);
+    REQUIRE(copy.value_table().size() == 4);
+    REQUIRE(copy.key_table()[0] == "class");
+}
+
+TEST_CASE("iterate over features using the features() range") {
+    const auto data = load_test_tile();
+    vtzero::vector_tile tile{data};
+    const auto layer = tile.get_layer_by_name("landuse");
+    REQUIRE(layer.valid());
+
+    std::size_t num = 0;
+    for (const auto& feature : layer.features()) {
+        REQUIRE(feature.valid());
+        ++num;
+    }
+    REQUIRE(num == layer.num_features());
+
+    // iterators are multi-pass and independent of each other
+    const auto range = layer.features();
+    auto it = range.begin();
+    const auto first_data = it->data();
+    auto it2 = it;
+    ++it2;
+    REQUIRE(it->data() == first_data);
+    REQUIRE_FALSE(it2->data() == first_data);
+    REQUIRE(std::distance(range.begin(), range.end()) == static_cast<std::ptrdiff_t>(layer.num_features()));
+
+    // an empty layer has an empty range
+    const auto empty_layer = tile.get_layer(8);
+    REQUIRE(empty_layer.num_features() == 0);
+    REQUIRE(empty_layer.features().begin() == empty_layer.features().end());
+}
+
+TEST_CASE("project one property key across a whole layer") {
+    const auto data = load_test_tile();
+    vtzero::vector_tile tile{data};
+    const auto layer = tile.get_layer_by_name("road");
+    REQUIRE(layer.valid());
+
+    // the reference result using the per-feature property iteration
+    std::vector<vtzero::property_value> expected;
+    layer.for_each_feature([&](const vtzero::feature& feature) {
+        feature.for_each_property([&](const vtzero::property& p) {
+            if (p.key() == "class") {
+                expected.push_back(p.value());
+            }
+            return true;
+        });
+        return true;
+    });
+    REQUIRE_FALSE(expected.empty());
+
+    SECTION("project the values") {
+        std::vector<vtzero::property_value> values;
+        const auto count = layer.project_property("class", [&](const vtzero::property_value value) {
+            values.push_back(value);
+        });
+        REQUIRE(count == expected.size());
+        REQUIRE(values.size() == expected.size());
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            REQUIRE(values[i] == expected[i]);
+        }
+    }
+
+    SECTION("project the value indexes") {
+        std::size_t num = 0;
+        const auto count = layer.project_property_indexes("class", [&](const vtzero::index_value index) {
+            REQUIRE(index.valid());
+            REQUIRE(layer.value(index) == expected[num]);
+            ++num;
+        });
+        REQUIRE(count == expected.size());
+        REQUIRE(num == expected.size());
+    }
+
+    SECTION("a key that is not in the layer matches nothing") {
+        const auto count = layer.project_property("no_such_key", [](const vtzero::property_value /*value*/) {
+            REQUIRE(false);
+        });
+        REQUIRE(count == 0);
+    }
+}
+
+TEST_CASE("decoded-value cache for the value table") {
+    const auto data = load_test_tile();
+    vtzero::vector_tile tile{data};
+    const auto layer = tile.get_layer_by_name("bridge");
+    REQUIRE(layer.valid());
+
+    REQUIRE_FALSE(layer.has_value_cache());
+    REQUIRE_THROWS_AS(layer.decoded_value(0), assert_error);
+
+    layer.build_value_cache();
+    REQUIRE(layer.has_value_cache());
+
+    // building the cache a second time does nothing
+    layer.build_value_cache();
+
+    // every entry decodes to the same type and value as the pbf parse
+    const auto& table = layer.value_table();
+    for (vtzero::index_value index = 0; index.value() < table.size(); index = index.value() + 1) {
+        const auto& decoded = layer.decoded_value(index);
+        const auto value = layer.value(index);
+        REQUIRE(decoded.type() == value.type());
+        switch (decoded.type()) {
+            case vtzero::property_value_type::string_value:
+                REQUIRE(decoded.string_value() == value.string_value());
+                break;
+            case vtzero::property_value_type::int_value:
+                REQUIRE(decoded.int_value() == value.int_value());
+                break;
+            default:
+                REQUIRE(false); // the bridge layer only has string and int values
+        }
+    }
+
+    REQUIRE(layer.decoded_value(0).string_value() == "main");
+    REQUIRE(layer.decoded_value(1).int_value() == 0);
+
+    // accessing a value with the wrong type throws like property_value does
+    REQUIRE_THROWS_AS(layer.decoded_value(0).int_value(), vtzero::type_exception);
+    REQUIRE_THROWS_AS(layer.decoded_value(1).string_value(), vtzero::type_exception);
+
+    REQUIRE_THROWS_AS(layer.decoded_value(4), vtzero::out_of_range_exception);
+}
+
+TEST_CASE("decoded-value cache with all value types") {
+    vtzero::tile_builder tbuilder;
+    vtzero::layer_builder lbuilder{tbuilder, "test"};
+    vtzero::point_feature_builder fbuilder{lbuilder};
+    fbuilder.add_point(1, 1);
+    fbuilder.add_property("string", "foo");
+    fbuilder.add_property("float", 1.5F);
+    fbuilder.add_property("double", 2.5);
+    fbuilder.add_property("int", vtzero::int_value_type{-3});
+    fbuilder.add_property("uint", vtzero::uint_value_type{4});
+    fbuilder.add_property("sint", vtzero::sint_value_type{-5});
+    fbuilder.add_property("bool", true);
+    fbuilder.commit();
+
+    const std::string data = tbuilder.serialize();
+    vtzero::vector_tile tile{data};
+    const auto layer = tile.next_layer();
+    layer.build_value_cache();
+
+    REQUIRE(layer.decoded_value(0).string_value() == "foo");
+    REQUIRE(layer.decoded_value(1).float_value() == Approx(1.5));
+    REQUIRE(layer.decoded_value(2).double_value() == Approx(2.5));
+    REQUIRE(layer.decoded_value(3).int_value() == -3);
+    REQUIRE(layer.decoded_value(4).uint_value() == 4);
+    REQUIRE(layer.decoded_value(5).sint_value() == -5);
+    REQUIRE(layer.decoded_value(6).bool_value());
+}
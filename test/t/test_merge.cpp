@@ -0,0 +1,126 @@
+
+#include <test.hpp>
+
+#include <vtzero/builder.hpp>
+#include <vtzero/merge.hpp>
+#include <vtzero/vector_tile.hpp>
+
+#include <string>
+
+static std::string build_tile_a() {
+    vtzero::tile_builder tbuilder;
+
+    vtzero::layer_builder roads{tbuilder, "roads"};
+    {
+        vtzero::point_feature_builder fbuilder{roads};
+        fbuilder.set_id(1);
+        fbuilder.add_point(10, 10);
+        fbuilder.add_property("highway", "primary");
+        fbuilder.commit();
+    }
+
+    vtzero::layer_builder pois{tbuilder, "pois"};
+    {
+        vtzero::point_feature_builder fbuilder{pois};
+        fbuilder.set_id(1);
+        fbuilder.add_point(20, 20);
+        fbuilder.add_property("amenity", "cafe");
+        fbuilder.commit();
+    }
+
+    return tbuilder.serialize();
+}
+
+static std::string build_tile_b() {
+    vtzero::tile_builder tbuilder;
+
+    vtzero::layer_builder roads{tbuilder, "roads"};
+    {
+        vtzero::point_feature_builder fbuilder{roads};
+        fbuilder.set_id(2);
+        fbuilder.add_point(30, 30);
+        fbuilder.add_property("highway", "primary");
+        fbuilder.add_property("name", "A1");
+        fbuilder.commit();
+    }
+
+    vtzero::layer_builder traffic{tbuilder, "traffic"};
+    {
+        vtzero::point_feature_builder fbuilder{traffic};
+        fbuilder.set_id(7);
+        fbuilder.add_point(40, 40);
+        fbuilder.add_property("speed", "slow");
+        fbuilder.commit();
+    }
+
+    return tbuilder.serialize();
+}
+
+TEST_CASE("Merge two tiles with a common layer") {
+    const std::string data_a = build_tile_a();
+    const std::string data_b = build_tile_b();
+
+    vtzero::tile_builder tbuilder;
+    vtzero::tile_merger merger{tbuilder};
+    merger.add_tile(data_a);
+    merger.add_tile(data_b);
+
+    const std::string data = tbuilder.serialize();
+    vtzero::vector_tile tile{data};
+
+    // layers in order of first appearance
+    auto roads = tile.next_layer();
+    REQUIRE(roads.name() == "roads");
+    REQUIRE(tile.next_layer().name() == "pois");
+    REQUIRE(tile.next_layer().name() == "traffic");
+    REQUIRE_FALSE(tile.next_layer());
+
+    REQUIRE(roads.num_features() == 2);
+
+    // the shared "highway"/"primary" entries are interned only once
+    REQUIRE(roads.key_table().size() == 2); // highway, name
+    REQUIRE(roads.value_table().size() == 2); // primary, A1
+
+    auto feature = roads.next_feature();
+    REQUIRE(feature.id() == 1);
+    auto property = feature.next_property();
+    REQUIRE(property.key() == "highway");
+    REQUIRE(property.value().string_value() == "primary");
+
+    feature = roads.next_feature();
+    REQUIRE(feature.id() == 2);
+    property = feature.next_property();
+    REQUIRE(property.key() == "highway");
+    REQUIRE(property.value().string_value() == "primary");
+    property = feature.next_property();
+    REQUIRE(property.key() == "name");
+    REQUIRE(property.value().string_value() == "A1");
+}
+
+TEST_CASE("Merge a tile with itself") {
+    const auto buffer = load_test_tile();
+    vtzero::vector_tile input{buffer};
+
+    vtzero::tile_builder tbuilder;
+    vtzero::tile_merger merger{tbuilder};
+    merger.add_tile(buffer);
+    merger.add_tile(buffer);
+
+    const std::string data = tbuilder.serialize();
+    vtzero::vector_tile tile{data};
+
+    while (auto layer = input.next_layer()) {
+        if (layer.empty()) { // empty input layers are skipped
+            continue;
+        }
+        auto merged_layer = tile.next_layer();
+        REQUIRE(merged_layer.name() == layer.name());
+        REQUIRE(merged_layer.version() == layer.version());
+        REQUIRE(merged_layer.extent() == layer.extent());
+        REQUIRE(merged_layer.num_features() == 2 * layer.num_features());
+        // the tables are deduplicated, so they don't grow
+        REQUIRE(merged_layer.key_table().size() == layer.key_table().size());
+        REQUIRE(merged_layer.value_table().size() == layer.value_table().size());
+    }
+    REQUIRE_FALSE(tile.next_layer());
+}
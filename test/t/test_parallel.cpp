@@ -0,0 +1,105 @@
+#include <test.hpp>
+
+#include <vtzero/parallel.hpp>
+#include <vtzero/vector_tile.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+TEST_CASE("iterate over all features in a layer in parallel") {
+    const auto data = load_test_tile();
+    vtzero::vector_tile tile{data};
+
+    const auto layer = tile.get_layer_by_name("building");
+    REQUIRE(layer);
+
+    uint64_t sequential_id_sum = 0;
+    layer.for_each_feature([&sequential_id_sum](const vtzero::feature& feature) noexcept {
+        sequential_id_sum += feature.id();
+        return true;
+    });
+
+    std::atomic<std::size_t> count{0};
+    std::atomic<uint64_t> id_sum{0};
+
+    const auto func = [&](const vtzero::feature& feature) {
+        ++count;
+        id_sum += feature.id();
+    };
+
+    SECTION("single thread") {
+        vtzero::for_each_feature_parallel(layer, func, 1);
+    }
+
+    SECTION("several threads") {
+        vtzero::for_each_feature_parallel(layer, func, 4);
+    }
+
+    SECTION("more threads than features") {
+        vtzero::for_each_feature_parallel(layer, func, 10000);
+    }
+
+    REQUIRE(count == 937);
+    REQUIRE(id_sum == sequential_id_sum);
+}
+
+TEST_CASE("iterate over all layers in a tile in parallel") {
+    const auto data = load_test_tile();
+    vtzero::vector_tile tile{data};
+
+    std::size_t sequential_feature_sum = 0;
+    tile.for_each_layer([&sequential_feature_sum](const vtzero::layer& layer) noexcept {
+        sequential_feature_sum += layer.num_features();
+        return true;
+    });
+
+    std::atomic<std::size_t> count{0};
+    std::atomic<std::size_t> feature_sum{0};
+
+    const auto func = [&](const vtzero::layer& layer) {
+        ++count;
+        feature_sum += layer.num_features();
+    };
+
+    SECTION("single thread") {
+        vtzero::for_each_layer_parallel(tile, func, 1);
+    }
+
+    SECTION("several threads") {
+        vtzero::for_each_layer_parallel(tile, func, 4);
+    }
+
+    SECTION("more threads than layers") {
+        vtzero::for_each_layer_parallel(tile, func, 10000);
+    }
+
+    REQUIRE(count == 12);
+    REQUIRE(feature_sum == sequential_feature_sum);
+}
+
+TEST_CASE("exception from the function is rethrown from parallel layer iteration") {
+    const auto data = load_test_tile();
+    vtzero::vector_tile tile{data};
+
+    const auto func = [](const vtzero::layer& /*layer*/) {
+        throw std::runtime_error{"broken"};
+    };
+
+    REQUIRE_THROWS_AS(vtzero::for_each_layer_parallel(tile, func, 4), std::runtime_error);
+}
+
+TEST_CASE("exception from the function is rethrown from parallel iteration") {
+    const auto data = load_test_tile();
+    vtzero::vector_tile tile{data};
+
+    const auto layer = tile.get_layer_by_name("building");
+    REQUIRE(layer);
+
+    const auto func = [](const vtzero::feature& /*feature*/) {
+        throw std::runtime_error{"broken"};
+    };
+
+    REQUIRE_THROWS_AS(vtzero::for_each_feature_parallel(layer, func, 4), std::runtime_error);
+}
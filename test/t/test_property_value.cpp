@@ -405,3 +405,26 @@ TEST_CASE("property inequality comparison operator") {
     REQUIRE(p1 != p3);
     REQUIRE(p3 != p4);
 }
+
+TEST_CASE("encoded property values with strings longer than the internal buffer") {
+    const std::string long_string(1000, 'x');
+
+    vtzero::encoded_property_value epv{long_string};
+    REQUIRE(vtzero::property_value{epv.data()}.string_value() == long_string);
+
+    // copies and moves must keep the data intact
+    vtzero::encoded_property_value copy{epv};
+    REQUIRE(copy == epv);
+    REQUIRE(vtzero::property_value{copy.data()}.string_value() == long_string);
+
+    const vtzero::encoded_property_value moved{std::move(copy)};
+    REQUIRE(moved == epv);
+    REQUIRE(vtzero::property_value{moved.data()}.string_value() == long_string);
+
+    vtzero::encoded_property_value small{42};
+    small = epv;
+    REQUIRE(small == epv);
+
+    REQUIRE(epv.hash() == moved.hash());
+    REQUIRE(epv.hash() != vtzero::encoded_property_value{42}.hash());
+}
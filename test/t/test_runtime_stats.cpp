@@ -0,0 +1,96 @@
+
+#include <test.hpp>
+
+#include <vtzero/builder.hpp>
+#include <vtzero/geometry.hpp>
+#include <vtzero/runtime_stats.hpp>
+#include <vtzero/vector_tile.hpp>
+
+#include <cstdint>
+#include <string>
+
+namespace {
+
+struct null_point_handler {
+
+    void points_begin(uint32_t /*count*/) const noexcept {
+    }
+
+    void points_point(vtzero::point /*point*/) const noexcept {
+    }
+
+    void points_end() const noexcept {
+    }
+
+}; // struct null_point_handler
+
+} // anonymous namespace
+
+TEST_CASE("runtime stats count decoding work") {
+    vtzero::reset_stats();
+
+    const auto buffer = load_test_tile();
+    vtzero::vector_tile tile{buffer};
+
+    uint64_t num_layers = 0;
+    uint64_t num_features = 0;
+    while (auto layer = tile.next_layer()) {
+        ++num_layers;
+        layer.key_table(); // force building the tables
+        while (layer.next_feature()) {
+            ++num_features;
+        }
+    }
+
+    const std::string geometry_data{9, 4, 4}; // MoveTo(2, 2)
+    null_point_handler handler;
+    vtzero::decode_point_geometry(vtzero::geometry{geometry_data, vtzero::GeomType::POINT}, handler);
+
+    const auto stats = vtzero::snapshot_stats();
+#ifdef VTZERO_STATS
+    REQUIRE(stats.features_decoded == num_features);
+    REQUIRE(stats.table_builds == num_layers);
+    REQUIRE(stats.geometries_decoded == 1);
+    REQUIRE(stats.points_decoded == 1);
+#else
+    REQUIRE(stats.features_decoded == 0);
+    REQUIRE(stats.table_builds == 0);
+    REQUIRE(stats.geometries_decoded == 0);
+    REQUIRE(stats.points_decoded == 0);
+#endif
+}
+
+TEST_CASE("runtime stats count building work and exceptions") {
+    vtzero::reset_stats();
+
+    vtzero::tile_builder tbuilder;
+    vtzero::layer_builder lbuilder{tbuilder, "test"};
+    {
+        vtzero::point_feature_builder fbuilder{lbuilder};
+        fbuilder.add_point(1, 1);
+        // long enough to force a heap allocation of the key table buffer
+        fbuilder.add_property("a_rather_long_key_so_the_key_table_buffer_has_to_grow_for_sure", 1);
+        fbuilder.commit();
+    }
+    const std::string data = tbuilder.serialize();
+    REQUIRE_FALSE(data.empty());
+
+    const std::string empty_geometry;
+    null_point_handler handler;
+    REQUIRE_THROWS_AS(vtzero::decode_point_geometry(vtzero::geometry{empty_geometry, vtzero::GeomType::POINT}, handler),
+                      vtzero::geometry_exception);
+
+    const auto stats = vtzero::snapshot_stats();
+#ifdef VTZERO_STATS
+    REQUIRE(stats.tiles_serialized == 1);
+    REQUIRE(stats.buffer_growths >= 1);
+    REQUIRE(stats.exceptions_thrown == 1);
+#else
+    REQUIRE(stats.tiles_serialized == 0);
+    REQUIRE(stats.buffer_growths == 0);
+    REQUIRE(stats.exceptions_thrown == 0);
+#endif
+
+    vtzero::reset_stats();
+    REQUIRE(vtzero::snapshot_stats().exceptions_thrown == 0);
+}
@@ -0,0 +1,114 @@
+
+#include <test.hpp>
+
+#include <vtzero/builder.hpp>
+#include <vtzero/schema.hpp>
+#include <vtzero/vector_tile.hpp>
+
+#include <array>
+#include <cstddef>
+#include <string>
+
+struct road_schema {
+
+    static constexpr std::size_t num_keys = 3;
+    static constexpr std::size_t num_values = 2;
+
+    static const char* name() {
+        return "roads";
+    }
+
+    static const std::array<const char*, num_keys>& keys() {
+        static const std::array<const char*, num_keys> keys{{"class", "ref", "oneway"}};
+        return keys;
+    }
+
+    static const std::array<vtzero::encoded_property_value, num_values>& values() {
+        static const std::array<vtzero::encoded_property_value, num_values> values{{
+            vtzero::encoded_property_value{"primary"},
+            vtzero::encoded_property_value{true}
+        }};
+        return values;
+    }
+
+}; // struct road_schema
+
+constexpr std::size_t road_schema::num_keys;
+constexpr std::size_t road_schema::num_values;
+
+using roads_builder = vtzero::static_layer_builder<road_schema>;
+
+TEST_CASE("Build a layer with a fixed schema") {
+    vtzero::tile_builder tbuilder;
+    roads_builder lbuilder{tbuilder};
+
+    {
+        vtzero::point_feature_builder fbuilder{lbuilder};
+        fbuilder.set_id(17);
+        fbuilder.add_point(10, 20);
+        fbuilder.add_property(roads_builder::key<0>(), roads_builder::value<0>());
+        fbuilder.add_property(roads_builder::key<2>(), roads_builder::value<1>());
+        fbuilder.commit();
+    }
+
+    const std::string data = tbuilder.serialize();
+    vtzero::vector_tile tile{data};
+
+    auto layer = tile.next_layer();
+    REQUIRE(layer.name() == "roads");
+    REQUIRE(layer.num_features() == 1);
+
+    const auto& key_table = layer.key_table();
+    REQUIRE(key_table.size() == 3);
+    REQUIRE(key_table[0] == "class");
+    REQUIRE(key_table[1] == "ref");
+    REQUIRE(key_table[2] == "oneway");
+
+    const auto& value_table = layer.value_table();
+    REQUIRE(value_table.size() == 2);
+    REQUIRE(value_table[0].string_value() == "primary");
+    REQUIRE(value_table[1].bool_value());
+
+    auto feature = layer.next_feature();
+    REQUIRE(feature.id() == 17);
+    auto property = feature.next_property();
+    REQUIRE(property.key() == "class");
+    REQUIRE(property.value().string_value() == "primary");
+    property = feature.next_property();
+    REQUIRE(property.key() == "oneway");
+    REQUIRE(property.value().bool_value());
+    REQUIRE_FALSE(feature.next_property());
+}
+
+TEST_CASE("Mix schema and dynamic properties in a static_layer_builder") {
+    vtzero::tile_builder tbuilder;
+    roads_builder lbuilder{tbuilder};
+
+    // the duplicate check sees the pre-encoded schema entries
+    REQUIRE(lbuilder.add_key("ref").value() == 1);
+    REQUIRE(lbuilder.add_value(vtzero::encoded_property_value{"primary"}).value() == 0);
+
+    {
+        vtzero::point_feature_builder fbuilder{lbuilder};
+        fbuilder.add_point(1, 1);
+        fbuilder.add_property(roads_builder::key<0>(), roads_builder::value<0>());
+        fbuilder.add_property("surface", "gravel");
+        fbuilder.commit();
+    }
+
+    const std::string data = tbuilder.serialize();
+    vtzero::vector_tile tile{data};
+
+    auto layer = tile.next_layer();
+    REQUIRE(layer.key_table().size() == 4);
+    REQUIRE(layer.key_table()[3] == "surface");
+    REQUIRE(layer.value_table().size() == 3);
+
+    auto feature = layer.next_feature();
+    auto property = feature.next_property();
+    REQUIRE(property.key() == "class");
+    REQUIRE(property.value().string_value() == "primary");
+    property = feature.next_property();
+    REQUIRE(property.key() == "surface");
+    REQUIRE(property.value().string_value() == "gravel");
+}
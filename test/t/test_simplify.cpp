@@ -0,0 +1,99 @@
+
+#include <test.hpp>
+
+#include <vtzero/simplify.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+struct collect_handler {
+
+    std::vector<vtzero::point> points{};
+    uint32_t announced_count = 0;
+
+    void linestring_begin(uint32_t count) {
+        announced_count = count;
+        points.reserve(count);
+    }
+
+    void linestring_point(const vtzero::point point) {
+        points.push_back(point);
+    }
+
+    void linestring_end() const noexcept {
+    }
+
+};
+
+} // anonymous namespace
+
+TEST_CASE("simplify_linestring_handler drops points within the tolerance") {
+    collect_handler handler;
+    vtzero::simplify_linestring_handler<collect_handler> simplifier{handler, 1.0};
+
+    simplifier.linestring_begin(5);
+    simplifier.linestring_point({0, 0});
+    simplifier.linestring_point({10, 1});
+    simplifier.linestring_point({20, 0});
+    simplifier.linestring_point({30, 10});
+    simplifier.linestring_point({40, 0});
+    simplifier.linestring_end();
+
+    REQUIRE(handler.announced_count == 4);
+    REQUIRE(handler.points.size() == 4);
+    REQUIRE(handler.points[0] == vtzero::point(0, 0));
+    REQUIRE(handler.points[1] == vtzero::point(20, 0));
+    REQUIRE(handler.points[2] == vtzero::point(30, 10));
+    REQUIRE(handler.points[3] == vtzero::point(40, 0));
+}
+
+TEST_CASE("simplify_linestring_handler with tolerance 0 keeps all points") {
+    collect_handler handler;
+    vtzero::simplify_linestring_handler<collect_handler> simplifier{handler, 0.0};
+
+    simplifier.linestring_begin(3);
+    simplifier.linestring_point({0, 0});
+    simplifier.linestring_point({10, 0});
+    simplifier.linestring_point({20, 0});
+    simplifier.linestring_end();
+
+    REQUIRE(handler.points.size() == 3);
+}
+
+TEST_CASE("simplify_linestring_handler always keeps first and last point") {
+    collect_handler handler;
+    vtzero::simplify_linestring_handler<collect_handler> simplifier{handler, 100.0};
+
+    simplifier.linestring_begin(4);
+    simplifier.linestring_point({0, 0});
+    simplifier.linestring_point({1, 1});
+    simplifier.linestring_point({2, 0});
+    simplifier.linestring_point({3, 1});
+    simplifier.linestring_end();
+
+    REQUIRE(handler.points.size() == 2);
+    REQUIRE(handler.points[0] == vtzero::point(0, 0));
+    REQUIRE(handler.points[1] == vtzero::point(3, 1));
+}
+
+TEST_CASE("simplify_linestring_handler can be reused for several linestrings") {
+    collect_handler handler;
+    vtzero::simplify_linestring_handler<collect_handler> simplifier{handler, 1.0};
+
+    simplifier.linestring_begin(3);
+    simplifier.linestring_point({0, 0});
+    simplifier.linestring_point({5, 0});
+    simplifier.linestring_point({10, 0});
+    simplifier.linestring_end();
+
+    simplifier.linestring_begin(2);
+    simplifier.linestring_point({0, 0});
+    simplifier.linestring_point({1, 1});
+    simplifier.linestring_end();
+
+    REQUIRE(handler.points.size() == 4);
+    REQUIRE(handler.points[2] == vtzero::point(0, 0));
+    REQUIRE(handler.points[3] == vtzero::point(1, 1));
+}
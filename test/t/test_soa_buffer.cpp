@@ -0,0 +1,111 @@
+#include <test.hpp>
+
+#include <vtzero/soa_buffer.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Encode the geometry data the same way it is encoded in a vector tile:
+// as a sequence of varints.
+static std::string encode_geometry_data(const std::vector<uint32_t>& values) {
+    std::string data;
+
+    for (auto value : values) {
+        while (value >= 0x80U) {
+            data += static_cast<char>((value & 0x7fU) | 0x80U);
+            value >>= 7U;
+        }
+        data += static_cast<char>(value);
+    }
+
+    return data;
+}
+
+TEST_CASE("decode a point geometry into a soa_buffer") {
+    const std::string data = encode_geometry_data({9, 50, 34});
+    const vtzero::geometry geom{vtzero::data_view{data}, vtzero::GeomType::POINT};
+
+    vtzero::soa_buffer buffer;
+    REQUIRE(vtzero::decode_to_soa(geom, buffer) == vtzero::GeomType::POINT);
+
+    REQUIRE(buffer.geometry_type() == vtzero::GeomType::POINT);
+    REQUIRE(buffer.num_parts() == 1);
+    REQUIRE(buffer.num_points() == 1);
+    REQUIRE(buffer.part_begin(0) == 0);
+    REQUIRE(buffer.part_end(0) == 1);
+    REQUIRE(buffer.x()[0] == 25);
+    REQUIRE(buffer.y()[0] == 17);
+    REQUIRE(buffer.ring_types().empty());
+}
+
+TEST_CASE("decode a multilinestring geometry into a soa_buffer") {
+    const std::string data = encode_geometry_data({9, 4, 4, 18, 0, 16, 16, 0, 9, 17, 17, 10, 4, 8});
+    const vtzero::geometry geom{vtzero::data_view{data}, vtzero::GeomType::LINESTRING};
+
+    vtzero::soa_buffer buffer;
+    REQUIRE(vtzero::decode_to_soa(geom, buffer) == vtzero::GeomType::LINESTRING);
+
+    REQUIRE(buffer.num_parts() == 2);
+    REQUIRE(buffer.num_points() == 5);
+
+    REQUIRE(buffer.part_begin(0) == 0);
+    REQUIRE(buffer.part_end(0) == 3);
+    REQUIRE(buffer.x()[0] == 2);
+    REQUIRE(buffer.y()[0] == 2);
+    REQUIRE(buffer.x()[1] == 2);
+    REQUIRE(buffer.y()[1] == 10);
+    REQUIRE(buffer.x()[2] == 10);
+    REQUIRE(buffer.y()[2] == 10);
+
+    REQUIRE(buffer.part_begin(1) == 3);
+    REQUIRE(buffer.part_end(1) == 5);
+    REQUIRE(buffer.x()[3] == 1);
+    REQUIRE(buffer.y()[3] == 1);
+    REQUIRE(buffer.x()[4] == 3);
+    REQUIRE(buffer.y()[4] == 5);
+}
+
+TEST_CASE("decode a polygon geometry into a soa_buffer") {
+    const std::string data = encode_geometry_data({9, 6, 12, 18, 10, 12, 24, 44, 15});
+    const vtzero::geometry geom{vtzero::data_view{data}, vtzero::GeomType::POLYGON};
+
+    vtzero::soa_buffer buffer;
+    REQUIRE(vtzero::decode_to_soa(geom, buffer) == vtzero::GeomType::POLYGON);
+
+    REQUIRE(buffer.num_parts() == 1);
+    REQUIRE(buffer.num_points() == 4);
+    REQUIRE(buffer.ring_types().size() == 1);
+    REQUIRE(buffer.ring_types()[0] == vtzero::ring_type::outer);
+
+    // the ring is closed: the last point is the same as the first
+    REQUIRE(buffer.x()[0] == 3);
+    REQUIRE(buffer.y()[0] == 6);
+    REQUIRE(buffer.x()[3] == 3);
+    REQUIRE(buffer.y()[3] == 6);
+}
+
+TEST_CASE("reuse a soa_buffer for several geometries") {
+    const std::string line_data = encode_geometry_data({9, 4, 4, 18, 0, 16, 16, 0});
+    const std::string point_data = encode_geometry_data({9, 50, 34});
+
+    vtzero::soa_buffer buffer;
+
+    vtzero::decode_to_soa(vtzero::geometry{vtzero::data_view{line_data}, vtzero::GeomType::LINESTRING}, buffer);
+    REQUIRE(buffer.num_points() == 3);
+
+    vtzero::decode_to_soa(vtzero::geometry{vtzero::data_view{point_data}, vtzero::GeomType::POINT}, buffer);
+    REQUIRE(buffer.geometry_type() == vtzero::GeomType::POINT);
+    REQUIRE(buffer.num_parts() == 1);
+    REQUIRE(buffer.num_points() == 1);
+    REQUIRE(buffer.x()[0] == 25);
+    REQUIRE(buffer.y()[0] == 17);
+}
+
+TEST_CASE("decoding a geometry of unknown type into a soa_buffer fails") {
+    const std::string data = encode_geometry_data({9, 50, 34});
+    const vtzero::geometry geom{vtzero::data_view{data}, vtzero::GeomType::UNKNOWN};
+
+    vtzero::soa_buffer buffer;
+    REQUIRE_THROWS_AS(vtzero::decode_to_soa(geom, buffer), vtzero::geometry_exception);
+}
@@ -0,0 +1,50 @@
+
+#include <test.hpp>
+
+#include <vtzero/stats.hpp>
+#include <vtzero/vector_tile.hpp>
+
+#include <cstdint>
+#include <string>
+
+TEST_CASE("scan_stats of an empty buffer") {
+    const auto stats = vtzero::scan_stats(vtzero::data_view{"", 0});
+    REQUIRE(stats.layers.empty());
+    REQUIRE(stats.layers_by_version[2] == 0);
+}
+
+TEST_CASE("scan_stats matches the layer-based API on a real tile") {
+    const auto data = load_test_tile();
+
+    const auto stats = vtzero::scan_stats(vtzero::data_view{data});
+    REQUIRE(stats.layers.size() == 12);
+
+    uint64_t version_sum = 0;
+    for (const auto count : stats.layers_by_version) {
+        version_sum += count;
+    }
+    REQUIRE(version_sum == 12);
+    REQUIRE(stats.layers_by_version[1] >= 1); // the "bridge" layer is v1
+
+    vtzero::vector_tile tile{data};
+    std::size_t n = 0;
+    while (auto layer = tile.next_layer()) {
+        const auto& lstats = stats.layers[n];
+        REQUIRE(lstats.name == layer.name());
+        REQUIRE(lstats.version == layer.version());
+        REQUIRE(lstats.extent == layer.extent());
+        REQUIRE(lstats.num_features == layer.num_features());
+        REQUIRE(lstats.raw_size == layer.data().size());
+        REQUIRE(lstats.key_table_size == layer.key_table().size());
+        REQUIRE(lstats.value_table_size == layer.value_table().size());
+
+        uint64_t geometries_size = 0;
+        layer.for_each_feature([&geometries_size](vtzero::feature&& feature) {
+            geometries_size += feature.geometry().data().size();
+            return true;
+        });
+        REQUIRE(lstats.geometries_size == geometries_size);
+
+        ++n;
+    }
+}
@@ -0,0 +1,132 @@
+
+#include <test.hpp>
+
+#include <vtzero/streaming.hpp>
+#include <vtzero/vector_tile.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::vector<std::string> decode_in_chunks(const std::string& data, const std::size_t chunk_size) {
+    std::vector<std::string> names;
+
+    vtzero::streaming_tile_decoder decoder;
+    for (std::size_t offset = 0; offset < data.size(); offset += chunk_size) {
+        const auto size = std::min(chunk_size, data.size() - offset);
+        decoder.add_chunk(vtzero::data_view{data.data() + offset, size}, [&](vtzero::layer&& layer) {
+            REQUIRE(layer.valid());
+            names.emplace_back(layer.name().data(), layer.name().size());
+        });
+    }
+    decoder.finish();
+    REQUIRE(decoder.buffered_size() == 0);
+
+    return names;
+}
+
+} // anonymous namespace
+
+TEST_CASE("decode a tile arriving in chunks") {
+    const auto data = load_test_tile();
+
+    // the layer names in the order they appear in the tile
+    std::vector<std::string> expected;
+    vtzero::vector_tile tile{data};
+    while (auto layer = tile.next_layer()) {
+        expected.emplace_back(layer.name().data(), layer.name().size());
+    }
+    REQUIRE(expected.size() == 12);
+
+    SECTION("everything in one chunk") {
+        REQUIRE(decode_in_chunks(data, data.size()) == expected);
+    }
+
+    SECTION("small chunks") {
+        REQUIRE(decode_in_chunks(data, 100) == expected);
+    }
+
+    SECTION("byte by byte") {
+        REQUIRE(decode_in_chunks(data, 1) == expected);
+    }
+}
+
+TEST_CASE("streaming decoder sees complete features") {
+    const auto data = load_test_tile();
+
+    std::size_t num_features = 0;
+    vtzero::streaming_tile_decoder decoder;
+    for (std::size_t offset = 0; offset < data.size(); offset += 1000) {
+        const auto size = std::min(std::size_t{1000}, data.size() - offset);
+        decoder.add_chunk(vtzero::data_view{data.data() + offset, size}, [&](vtzero::layer&& layer) {
+            while (auto feature = layer.next_feature()) {
+                REQUIRE(feature.valid());
+                ++num_features;
+            }
+        });
+    }
+    decoder.finish();
+
+    std::size_t expected = 0;
+    vtzero::vector_tile tile{data};
+    while (auto layer = tile.next_layer()) {
+        expected += layer.num_features();
+    }
+    REQUIRE(num_features == expected);
+}
+
+TEST_CASE("streaming decoder with truncated data") {
+    const auto data = load_test_tile();
+
+    vtzero::streaming_tile_decoder decoder;
+    std::size_t num_layers = 0;
+    decoder.add_chunk(vtzero::data_view{data.data(), data.size() - 1}, [&](vtzero::layer&& /*layer*/) {
+        ++num_layers;
+    });
+
+    REQUIRE(num_layers == 11);
+    REQUIRE(decoder.buffered_size() > 0);
+    REQUIRE_THROWS_AS(decoder.finish(), vtzero::format_exception);
+
+    SECTION("the missing data can still arrive") {
+        decoder.add_chunk(vtzero::data_view{data.data() + data.size() - 1, 1}, [&](vtzero::layer&& /*layer*/) {
+            ++num_layers;
+        });
+        REQUIRE(num_layers == 12);
+        decoder.finish();
+    }
+
+    SECTION("reset() makes the decoder usable for the next tile") {
+        decoder.reset();
+        REQUIRE(decoder.buffered_size() == 0);
+        decoder.finish();
+
+        num_layers = 0;
+        decoder.add_chunk(data, [&](vtzero::layer&& /*layer*/) {
+            ++num_layers;
+        });
+        REQUIRE(num_layers == 12);
+        decoder.finish();
+    }
+}
+
+TEST_CASE("streaming decoder handles empty chunks") {
+    const auto data = load_test_tile();
+
+    vtzero::streaming_tile_decoder decoder;
+    std::size_t num_layers = 0;
+    const auto func = [&](vtzero::layer&& /*layer*/) {
+        ++num_layers;
+    };
+
+    decoder.add_chunk(vtzero::data_view{}, func);
+    decoder.add_chunk(vtzero::data_view{data.data(), data.size() / 2}, func);
+    decoder.add_chunk(vtzero::data_view{"", 0}, func);
+    decoder.add_chunk(vtzero::data_view{data.data() + data.size() / 2, data.size() - data.size() / 2}, func);
+    decoder.finish();
+
+    REQUIRE(num_layers == 12);
+}
@@ -0,0 +1,91 @@
+
+#include <test.hpp>
+
+#include <vtzero/tile_index.hpp>
+#include <vtzero/vector_tile.hpp>
+
+#include <cstddef>
+#include <string>
+
+TEST_CASE("build and load a sidecar tile index") {
+    const auto data = load_test_tile();
+    const std::string index_data = vtzero::build_tile_index(data);
+    REQUIRE_FALSE(index_data.empty());
+
+    // the index is much smaller than the tile itself
+    REQUIRE(index_data.size() < data.size() / 4);
+
+    const vtzero::tile_index index{data, index_data};
+
+    vtzero::vector_tile tile{data};
+    REQUIRE(index.num_layers() == tile.count_layers());
+
+    // every layer from the index matches the layer from the tile scan
+    for (std::size_t n = 0; n < index.num_layers(); ++n) {
+        const auto layer = index.get_layer(n);
+        const auto ref_layer = tile.get_layer(n);
+        REQUIRE(layer.valid());
+        REQUIRE(layer.data() == ref_layer.data());
+        REQUIRE(layer.name() == ref_layer.name());
+        REQUIRE(layer.num_features() == ref_layer.num_features());
+
+        // the feature index comes pre-populated from the sidecar
+        REQUIRE(layer.has_feature_index());
+    }
+
+    REQUIRE_FALSE(index.get_layer(index.num_layers()).valid());
+}
+
+TEST_CASE("features are accessible through the pre-populated index") {
+    const auto data = load_test_tile();
+    const std::string index_data = vtzero::build_tile_index(data);
+    const vtzero::tile_index index{data, index_data};
+
+    vtzero::vector_tile tile{data};
+
+    std::size_t building_index = 0;
+    for (std::size_t n = 0; n < tile.count_layers(); ++n) {
+        if (tile.get_layer(n).name() == "building") {
+            building_index = n;
+        }
+    }
+
+    const auto layer = index.get_layer(building_index);
+    REQUIRE(layer.name() == "building");
+    REQUIRE(layer.num_features() == 937);
+
+    const auto first = layer.get_feature(0);
+    REQUIRE(first.id() == 1);
+
+    const auto feature = layer.get_feature_by_id(122);
+    REQUIRE(feature.id() == 122);
+    REQUIRE(feature.geometry_type() == vtzero::GeomType::POLYGON);
+
+    REQUIRE_FALSE(layer.get_feature_by_id(999999));
+}
+
+TEST_CASE("tile index detects data it does not fit") {
+    const auto data = load_test_tile();
+    const std::string index_data = vtzero::build_tile_index(data);
+
+    SECTION("truncated tile data") {
+        const vtzero::data_view truncated{data.data(), data.size() / 2};
+        REQUIRE_THROWS_AS((vtzero::tile_index{truncated, index_data}),
+                          vtzero::format_exception);
+    }
+
+    SECTION("unknown index version") {
+        std::string bad_version;
+        protozero::pbf_builder<vtzero::detail::pbf_tile_index> builder{bad_version};
+        builder.add_uint32(vtzero::detail::pbf_tile_index::version, 99);
+        REQUIRE_THROWS_AS((vtzero::tile_index{data, bad_version}),
+                          vtzero::format_exception);
+    }
+}
+
+TEST_CASE("tile index for an empty tile") {
+    const std::string no_data;
+    const std::string index_data = vtzero::build_tile_index(no_data);
+    const vtzero::tile_index index{no_data, index_data};
+    REQUIRE(index.num_layers() == 0);
+}
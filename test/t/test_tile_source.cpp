@@ -0,0 +1,55 @@
+
+#include <test.hpp>
+
+#include <vtzero/tile_source.hpp>
+#include <vtzero/vector_tile.hpp>
+
+#include <string>
+
+TEST_CASE("is_gzip_compressed") {
+    const std::string gzip{'\x1f', '\x8b', '\x08', '\x00'};
+    REQUIRE(vtzero::is_gzip_compressed(vtzero::data_view{gzip}));
+
+    const std::string plain{"\x1a\x05hello"};
+    REQUIRE_FALSE(vtzero::is_gzip_compressed(vtzero::data_view{plain}));
+
+    REQUIRE_FALSE(vtzero::is_gzip_compressed(vtzero::data_view{}));
+}
+
+TEST_CASE("tile_source hands out uncompressed data zero-copy") {
+    const auto data = load_test_tile();
+
+    vtzero::tile_source source;
+    const auto tile = source.get_tile(vtzero::data_view{data});
+
+    // no copy was made
+    REQUIRE(tile.data().data() == data.data());
+    REQUIRE(tile.count_layers() == 12);
+}
+
+TEST_CASE("tile_source inflates compressed data into its internal buffer") {
+    const auto data = load_test_tile();
+
+    // stand-in for real gzip data: correct magic bytes, the "inflate"
+    // function below just appends the real tile data
+    const std::string compressed{'\x1f', '\x8b', '\x08', '\x00'};
+
+    vtzero::tile_source source;
+    int calls = 0;
+    const auto tile = source.get_tile(vtzero::data_view{compressed}, [&](vtzero::data_view input, std::string& output) {
+        ++calls;
+        REQUIRE(input.data() == compressed.data());
+        output.append(data);
+    });
+
+    REQUIRE(calls == 1);
+    REQUIRE(tile.data().data() != data.data());
+    REQUIRE(tile.count_layers() == 12);
+}
+
+TEST_CASE("tile_source without decompression function rejects compressed data") {
+    const std::string compressed{'\x1f', '\x8b', '\x08', '\x00'};
+
+    vtzero::tile_source source;
+    REQUIRE_THROWS_AS(source.get_tile(vtzero::data_view{compressed}), vtzero::format_exception);
+}
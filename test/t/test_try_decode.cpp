@@ -0,0 +1,164 @@
+
+#include <test.hpp>
+
+#include <vtzero/try_decode.hpp>
+#include <vtzero/vector_tile.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct collect_handler {
+
+    std::vector<vtzero::point> points{};
+    int begin_calls = 0;
+    int end_calls = 0;
+
+    void points_begin(uint32_t /*count*/) {
+        ++begin_calls;
+    }
+
+    void points_point(const vtzero::point point) {
+        points.push_back(point);
+    }
+
+    void points_end() {
+        ++end_calls;
+    }
+
+    void linestring_begin(uint32_t /*count*/) {
+        ++begin_calls;
+    }
+
+    void linestring_point(const vtzero::point point) {
+        points.push_back(point);
+    }
+
+    void linestring_end() {
+        ++end_calls;
+    }
+
+    void ring_begin(uint32_t /*count*/) {
+        ++begin_calls;
+    }
+
+    void ring_point(const vtzero::point point) {
+        points.push_back(point);
+    }
+
+    void ring_end(vtzero::ring_type /*type*/) {
+        ++end_calls;
+    }
+
+}; // struct collect_handler
+
+} // anonymous namespace
+
+TEST_CASE("try_decode_point_geometry decodes a valid point") {
+    const std::string data{9, 4, 4}; // MoveTo(2, 2)
+
+    collect_handler handler;
+    const auto err = vtzero::try_decode_point_geometry(vtzero::geometry{data, vtzero::GeomType::POINT}, handler);
+
+    REQUIRE(err.ok());
+    REQUIRE(err.offset == 0);
+    REQUIRE(handler.points.size() == 1);
+    REQUIRE(handler.points.front() == vtzero::point(2, 2));
+    REQUIRE(handler.end_calls == 1);
+}
+
+TEST_CASE("try_decode_linestring_geometry decodes a valid linestring") {
+    const std::string data{9, 4, 4, 18, 0, 16, 16, 0}; // MoveTo(2,2), LineTo(0,8),(8,0)
+
+    collect_handler handler;
+    const auto err = vtzero::try_decode_linestring_geometry(vtzero::geometry{data, vtzero::GeomType::LINESTRING}, handler);
+
+    REQUIRE(err.ok());
+    REQUIRE(handler.points.size() == 3);
+    REQUIRE(handler.points[1] == vtzero::point(2, 10));
+    REQUIRE(handler.points[2] == vtzero::point(10, 10));
+}
+
+TEST_CASE("try_decode_polygon_geometry decodes a valid polygon") {
+    const std::string data{9, 6, 12, 18, 10, 12, 24, 44, 15}; // same as spec 4.3.5.3 example ring
+
+    collect_handler handler;
+    const auto err = vtzero::try_decode_polygon_geometry(vtzero::geometry{data, vtzero::GeomType::POLYGON}, handler);
+
+    REQUIRE(err.ok());
+    REQUIRE(handler.points.size() == 4); // ring is closed, start point repeated
+    REQUIRE(handler.points.front() == handler.points.back());
+    REQUIRE(handler.end_calls == 1);
+}
+
+TEST_CASE("try_decode_geometry reports malformed geometries without throwing") {
+    collect_handler handler;
+
+    SECTION("empty point geometry") {
+        const std::string data;
+        const auto err = vtzero::try_decode_point_geometry(vtzero::geometry{data, vtzero::GeomType::POINT}, handler);
+        REQUIRE(err.code == vtzero::geometry_error_code::missing_command);
+    }
+
+    SECTION("additional data after a point") {
+        const std::string data{9, 4, 4, 9, 4, 4};
+        const auto err = vtzero::try_decode_point_geometry(vtzero::geometry{data, vtzero::GeomType::POINT}, handler);
+        REQUIRE(err.code == vtzero::geometry_error_code::extra_data);
+        REQUIRE(err.offset == 3);
+    }
+
+    SECTION("point with missing coordinate") {
+        const std::string data{9, 4};
+        const auto err = vtzero::try_decode_point_geometry(vtzero::geometry{data, vtzero::GeomType::POINT}, handler);
+        REQUIRE(err.code == vtzero::geometry_error_code::too_few_points);
+    }
+
+    SECTION("truncated varint") {
+        const std::string data{static_cast<char>(0x89)};
+        const auto err = vtzero::try_decode_point_geometry(vtzero::geometry{data, vtzero::GeomType::POINT}, handler);
+        REQUIRE(err.code == vtzero::geometry_error_code::truncated);
+    }
+
+    SECTION("linestring starting with the wrong command") {
+        const std::string data{10, 4, 4}; // LineTo instead of MoveTo
+        const auto err = vtzero::try_decode_linestring_geometry(vtzero::geometry{data, vtzero::GeomType::LINESTRING}, handler);
+        REQUIRE(err.code == vtzero::geometry_error_code::unexpected_command);
+    }
+
+    SECTION("polygon with invalid ClosePath count") {
+        const std::string data{9, 6, 12, 18, 10, 12, 24, 44, 23}; // ClosePath count 2
+        const auto err = vtzero::try_decode_polygon_geometry(vtzero::geometry{data, vtzero::GeomType::POLYGON}, handler);
+        REQUIRE(err.code == vtzero::geometry_error_code::invalid_command_count);
+        REQUIRE(err.offset == data.size());
+    }
+
+    SECTION("unknown geometry type") {
+        const std::string data{9, 4, 4};
+        const auto err = vtzero::try_decode_geometry(vtzero::geometry{data, vtzero::GeomType::UNKNOWN}, handler);
+        REQUIRE(err.code == vtzero::geometry_error_code::unknown_geometry_type);
+    }
+
+    REQUIRE(std::string{"okay"} == vtzero::geometry_error_message(vtzero::geometry_error_code::ok));
+}
+
+TEST_CASE("try_decode_geometry matches the throwing decoder on real data") {
+    const auto buffer = load_test_tile();
+    vtzero::vector_tile tile{buffer};
+
+    auto layer = tile.get_layer_by_name("road");
+    REQUIRE(layer);
+
+    while (auto feature = layer.next_feature()) {
+        collect_handler checked;
+        collect_handler nothrow;
+
+        vtzero::decode_geometry(feature.geometry(), checked);
+        const auto err = vtzero::try_decode_geometry(feature.geometry(), nothrow);
+
+        REQUIRE(err.ok());
+        REQUIRE(nothrow.points == checked.points);
+        REQUIRE(nothrow.end_calls == checked.end_calls);
+    }
+}
@@ -0,0 +1,70 @@
+
+#include <test.hpp>
+
+#include <vtzero/builder.hpp>
+#include <vtzero/validate.hpp>
+
+#include <algorithm>
+#include <string>
+
+TEST_CASE("validate a real tile") {
+    const auto data = load_test_tile();
+
+    vtzero::validation_result result;
+    vtzero::validate(vtzero::data_view{data}, result);
+
+    // the old tile in the test data predates the v2 winding order rules
+    // and contains a layer without features
+    REQUIRE(result.return_code() == 2);
+    REQUIRE_FALSE(result.ok());
+    REQUIRE(std::find(result.messages().cbegin(), result.messages().cend(),
+                      "Warning: No features in layer 8 (spec 4.1)") != result.messages().cend());
+    REQUIRE(std::find(result.messages().cbegin(), result.messages().cend(),
+                      "Error in layer 0 in feature 0 in geometry 0: First ring isn't an outer ring") != result.messages().cend());
+
+    result.clear();
+    REQUIRE(result.ok());
+    REQUIRE(result.messages().empty());
+}
+
+TEST_CASE("validate an empty buffer") {
+    vtzero::validation_result result;
+    vtzero::validate(vtzero::data_view{"", 0}, result);
+
+    REQUIRE(result.return_code() == 1);
+    REQUIRE(result.messages().front() == "Warning: No layers in vector tile (spec 4.1)");
+}
+
+TEST_CASE("validate a tile with duplicate layer names") {
+    vtzero::tile_builder tbuilder;
+    vtzero::layer_builder lbuilder1{tbuilder, "test"};
+    vtzero::layer_builder lbuilder2{tbuilder, "test"};
+
+    {
+        vtzero::point_feature_builder fbuilder{lbuilder1};
+        fbuilder.add_point(10, 10);
+        fbuilder.commit();
+    }
+    {
+        vtzero::point_feature_builder fbuilder{lbuilder2};
+        fbuilder.add_point(20, 20);
+        fbuilder.commit();
+    }
+
+    const std::string data = tbuilder.serialize();
+
+    vtzero::validation_result result;
+    vtzero::validate(vtzero::data_view{data}, result);
+
+    REQUIRE(result.return_code() == 2);
+    REQUIRE(result.messages().front() == "Error in layer 1: name is duplicate of previous layer ('test') (spec 4.1)");
+}
+
+TEST_CASE("validate garbage data") {
+    const std::string data{"this is not a vector tile at all and never will be"};
+
+    vtzero::validation_result result;
+    vtzero::validate(vtzero::data_view{data}, result);
+
+    REQUIRE(result.return_code() == 3);
+}
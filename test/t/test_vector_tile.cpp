@@ -3,6 +3,7 @@
 
 #include <vtzero/vector_tile.hpp>
 
+#include <iterator>
 #include <string>
 #include <vector>
 
@@ -73,6 +74,44 @@ TEST_CASE("get layer by name") {
     REQUIRE_FALSE(layer);
 }
 
+TEST_CASE("get layer by index using the layer index") {
+    const auto data = load_test_tile();
+    vtzero::vector_tile tile{data};
+
+    REQUIRE_FALSE(tile.has_layer_index());
+    tile.build_layer_index();
+    REQUIRE(tile.has_layer_index());
+
+    auto layer = tile.get_layer(0);
+    REQUIRE(layer);
+    REQUIRE(layer.name() == "landuse");
+
+    layer = tile.get_layer(11);
+    REQUIRE(layer);
+    REQUIRE(layer.name() == "waterway_label");
+
+    layer = tile.get_layer(12);
+    REQUIRE_FALSE(layer);
+}
+
+TEST_CASE("get layer by name using the layer index") {
+    const auto data = load_test_tile();
+    vtzero::vector_tile tile{data};
+
+    tile.build_layer_index();
+
+    auto layer = tile.get_layer_by_name("landuse");
+    REQUIRE(layer);
+    REQUIRE(layer.name() == "landuse");
+
+    layer = tile.get_layer_by_name(std::string{"road"});
+    REQUIRE(layer);
+    REQUIRE(layer.name() == "road");
+
+    layer = tile.get_layer_by_name("unknown");
+    REQUIRE_FALSE(layer);
+}
+
 TEST_CASE("iterate over layers") {
     const auto data = load_test_tile();
     vtzero::vector_tile tile{data};
@@ -137,3 +176,30 @@ TEST_CASE("iterate over some of the layers") {
     REQUIRE(num_layers == 3);
 }
 
+
+TEST_CASE("iterate over layers using the layers() range") {
+    const auto data = load_test_tile();
+    vtzero::vector_tile tile{data};
+
+    std::size_t num = 0;
+    for (const auto& layer : tile.layers()) {
+        REQUIRE(layer.valid());
+        ++num;
+    }
+    REQUIRE(num == tile.count_layers());
+
+    // the range is independent of the next_layer() cursor
+    tile.next_layer();
+    const auto range = tile.layers();
+    REQUIRE(range.begin()->name() == "landuse");
+
+    // iterators are multi-pass: advancing a copy doesn't change the
+    // original
+    auto it = range.begin();
+    auto it2 = it;
+    ++it2;
+    REQUIRE(it->name() == "landuse");
+    REQUIRE(it2->name() == "waterway");
+    REQUIRE(it != it2);
+    REQUIRE(std::distance(range.begin(), range.end()) == 12);
+}